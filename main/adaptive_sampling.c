@@ -0,0 +1,50 @@
+#include "adaptive_sampling.h"
+
+static uint8_t distancia(uint8_t a, uint8_t b) {
+    return a > b ? a - b : b - a;
+}
+
+uint32_t adaptive_update(adaptive_state_t *e, const adaptive_config_t *c, uint32_t base_ms, uint32_t agora_s, uint8_t percent) {
+    if (base_ms < c->intervalo_min_ms) base_ms = c->intervalo_min_ms;
+    uint32_t maximo = c->intervalo_max_ms > base_ms ? c->intervalo_max_ms : base_ms;
+
+    if (!e->iniciado) {
+        e->iniciado = true;
+        e->derivada = 0;
+        e->intervalo_ms = base_ms;
+    } else {
+        uint32_t dt = agora_s - e->avaliado_s;
+        if (dt == 0) dt = 1;
+        int32_t derivada = ((int32_t)percent - (int32_t)e->avaliado_percent) * 3600 / (int32_t)dt;
+        e->derivada += (derivada - e->derivada) / 2;
+
+        uint32_t modulo = e->derivada < 0 ? (uint32_t)-e->derivada : (uint32_t)e->derivada;
+        if (modulo >= c->derivada_rapida) {
+            e->intervalo_ms = c->intervalo_min_ms;
+        } else if (modulo <= c->derivada_estavel) {
+            // Sai do modo rápido pelo intervalo base antes de começar a espaçar.
+            uint32_t proximo = e->intervalo_ms < base_ms ? base_ms : e->intervalo_ms * 2;
+            e->intervalo_ms = proximo < maximo ? proximo : maximo;
+        } else {
+            e->intervalo_ms = base_ms;
+        }
+    }
+    e->avaliado_s = agora_s;
+    e->avaliado_percent = percent;
+    return e->intervalo_ms;
+}
+
+bool adaptive_should_report(adaptive_state_t *e, const adaptive_config_t *c, uint32_t agora_s, uint8_t percent, bool mudou_estado) {
+    bool publicar = !e->publicou || mudou_estado || distancia(percent, e->publicado_percent) >= c->banda_morta ||
+                    agora_s - e->publicado_s >= c->heartbeat_s;
+    if (publicar) {
+        e->publicou = true;
+        e->publicado_s = agora_s;
+        e->publicado_percent = percent;
+    }
+    return publicar;
+}
+
+bool adaptive_moved(const adaptive_state_t *e, const adaptive_config_t *c, uint8_t percent) {
+    return e->iniciado && distancia(percent, e->avaliado_percent) >= c->banda_morta;
+}
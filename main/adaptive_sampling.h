@@ -0,0 +1,43 @@
+#pragma once
+
+// Agendador de leituras com taxa adaptativa e publicação por exceção, por vaso.
+// A cada avaliação a derivada da umidade (média exponencial, em %/h) escolhe o próximo intervalo:
+//   |derivada| >= derivada_rapida  -> intervalo_min (o solo está sendo regado ou drenando)
+//   |derivada| <= derivada_estavel -> o intervalo dobra a cada ciclo até intervalo_max
+//   entre os dois                  -> o intervalo configurado (base)
+// A leitura só é publicada se andou pelo menos banda_morta desde a última publicada, se o estado
+// seco/úmido mudou ou se passou heartbeat_s sem publicar.
+// Este módulo não depende do ESP-IDF para poder ser usado no replay de traços (tools/).
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t intervalo_min_ms;
+    uint32_t intervalo_max_ms;
+    uint16_t derivada_rapida;    // %/h.
+    uint16_t derivada_estavel;   // %/h.
+    uint8_t banda_morta;         // %.
+    uint32_t heartbeat_s;
+} adaptive_config_t;
+
+typedef struct {
+    uint32_t avaliado_s;         // Instante da última avaliação.
+    uint32_t publicado_s;        // Instante da última publicação.
+    int32_t derivada;            // %/h, suavizada.
+    uint32_t intervalo_ms;       // Intervalo escolhido na última avaliação.
+    uint8_t avaliado_percent;
+    uint8_t publicado_percent;
+    bool iniciado;
+    bool publicou;
+} adaptive_state_t;
+
+// Registra uma avaliação e retorna o intervalo até a próxima (base_ms é o intervalo configurado).
+uint32_t adaptive_update(adaptive_state_t *e, const adaptive_config_t *c, uint32_t base_ms, uint32_t agora_s, uint8_t percent);
+
+// Decide se a leitura deve ser publicada; quando retorna true, ela passa a ser a última publicada.
+bool adaptive_should_report(adaptive_state_t *e, const adaptive_config_t *c, uint32_t agora_s, uint8_t percent, bool mudou_estado);
+
+// True se a umidade saiu da banda morta em relação à última avaliação (usado para acordar antes
+// do fim do intervalo quando há leituras contínuas disponíveis).
+bool adaptive_moved(const adaptive_state_t *e, const adaptive_config_t *c, uint8_t percent);
@@ -0,0 +1,24 @@
+#pragma once
+
+// Camada fina entre a lógica do SoloScan (main.c) e o hardware da placa.
+// No ESP32 (board_esp32.c) os LEDs são GPIOs e a rede é o Wi-Fi em modo estação.
+// As leituras seguem a interface de sensor_adc.h, implementada pelo ADC contínuo (sensor_adc.c).
+
+#include <stdbool.h>
+#include "driver/gpio.h"
+#include "hal/adc_types.h"
+
+typedef adc_channel_t board_channel_t;
+typedef gpio_num_t board_led_t;
+#define BOARD_SEM_LED   GPIO_NUM_NC
+
+// Configura o LED como saída (liberando o estado travado durante o deep sleep). Ignora BOARD_SEM_LED.
+void board_led_init(board_led_t led);
+
+void board_led_set(board_led_t led, bool aceso);
+
+// Trava o LED no estado atual durante o deep sleep.
+void board_led_hold(board_led_t led);
+
+// Inicia a rede sem bloquear. ao_conectar é chamado, na tarefa de eventos, toda vez que há IP.
+void board_network_start(const char *ssid, const char *senha, void (*ao_conectar)(void));
@@ -0,0 +1,75 @@
+#include "board.h"
+#include <string.h>
+#include "esp_wifi.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "low_power.h"
+#include "metrics.h"
+
+static const char *TAG = "BOARD";
+
+static esp_netif_t *s_sta_netif;
+static wifi_config_t s_wifi_config;
+static void (*s_ao_conectar)(void);
+static int64_t s_wifi_inicio_us; // Início da conexão Wi-Fi em andamento (0 se conectado).
+
+void board_led_init(board_led_t led) {
+    if (led == BOARD_SEM_LED) return;
+    gpio_hold_dis(led); // Libera o LED caso tenha sido travado antes do deep sleep.
+    gpio_reset_pin(led);
+    gpio_set_direction(led, GPIO_MODE_OUTPUT);
+}
+
+void board_led_set(board_led_t led, bool aceso) {
+    if (led != BOARD_SEM_LED) gpio_set_level(led, aceso);
+}
+
+void board_led_hold(board_led_t led) {
+    if (led == BOARD_SEM_LED) return;
+    gpio_hold_en(led);
+    gpio_deep_sleep_hold_en();
+}
+
+// Gerencia eventos de Wi-Fi, como reconexão automática e status de conexão.
+static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
+    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+        s_wifi_inicio_us = metrics_start();
+        esp_wifi_connect();
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        if (s_wifi_inicio_us == 0) s_wifi_inicio_us = metrics_start(); // Só a primeira queda de uma sequência de tentativas.
+        ESP_LOGI(TAG, "Falha ao conectar ao Wi-Fi. Tentando novamente...");
+        low_power_invalidate_wifi_cache();
+        esp_wifi_connect();
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
+        ESP_LOGI(TAG, "Conectado! Endereço IP: " IPSTR, IP2STR(&event->ip_info.ip));
+        if (s_wifi_inicio_us != 0) {
+            metrics_record_since(METRIC_WIFI_CONNECT, s_wifi_inicio_us);
+            s_wifi_inicio_us = 0;
+        }
+        low_power_save_wifi_cache(s_sta_netif, &event->ip_info);
+        s_ao_conectar();
+    }
+}
+
+// Configura e inicia o Wi-Fi sem esperar a conexão; o boot continua enquanto o ESP32 se associa.
+void board_network_start(const char *ssid, const char *senha, void (*ao_conectar)(void)) {
+    s_ao_conectar = ao_conectar;
+    strncpy((char *)s_wifi_config.sta.ssid, ssid, sizeof(s_wifi_config.sta.ssid));
+    strncpy((char *)s_wifi_config.sta.password, senha, sizeof(s_wifi_config.sta.password));
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+    s_sta_netif = esp_netif_create_default_wifi_sta();
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    esp_event_handler_instance_t instance_any_id;
+    esp_event_handler_instance_t instance_got_ip;
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL, &instance_any_id));
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL, &instance_got_ip));
+    // Ao acordar do deep sleep, reaproveita AP e IP da última conexão.
+    low_power_apply_wifi_cache(s_sta_netif, &s_wifi_config);
+    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
+    ESP_ERROR_CHECK(esp_wifi_set_config(ESP_IF_WIFI_STA, &s_wifi_config));
+    ESP_ERROR_CHECK(esp_wifi_start());
+    ESP_LOGI(TAG, "Conectando ao Wi-Fi em segundo plano...");
+}
@@ -0,0 +1,93 @@
+#include "clock_sync.h"
+#include <time.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "esp_netif_sntp.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+static const char *TAG = "RELOGIO";
+
+// Sobrevivem ao deep sleep: as leituras guardadas na flash antes de um despertar ainda podem ser corrigidas.
+static RTC_DATA_ATTR bool s_tem_deslocamento;
+static RTC_DATA_ATTR uint8_t s_boot_deslocamento;
+static RTC_DATA_ATTR uint32_t s_deslocamento;
+static RTC_DATA_ATTR uint32_t s_sincronizado_em;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t s_boot;
+static uint32_t s_relogio_inicio; // Relógio do sistema e esp_timer lidos juntos, para saber a hora
+static int64_t s_mono_inicio_us;  // de antes do acerto dentro do callback do SNTP.
+static int64_t s_sntp_inicio_us;
+static bool s_iniciado;
+
+static bool relogio_valido(void) {
+    return (uint32_t)time(NULL) >= CLOCK_SYNC_EPOCH_MIN;
+}
+
+esp_err_t clock_sync_init(void) {
+    s_relogio_inicio = (uint32_t)time(NULL);
+    s_mono_inicio_us = esp_timer_get_time();
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open("storage", NVS_READWRITE, &handle);
+    if (err != ESP_OK) return err;
+    uint32_t boots = 0;
+    nvs_get_u32(handle, "boots", &boots);
+    if (esp_reset_reason() != ESP_RST_DEEPSLEEP) {
+        boots++;
+        err = nvs_set_u32(handle, "boots", boots);
+        if (err == ESP_OK) err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    s_boot = (uint8_t)boots;
+    return err;
+}
+
+static void ao_sincronizar(struct timeval *tv) {
+    // Relógio do sistema logo antes do acerto, reconstruído pelo esp_timer.
+    uint32_t antes = s_relogio_inicio + (uint32_t)((esp_timer_get_time() - s_mono_inicio_us) / 1000000);
+    portENTER_CRITICAL(&s_lock);
+    if (antes < CLOCK_SYNC_EPOCH_MIN && !s_tem_deslocamento) {
+        s_deslocamento = (uint32_t)tv->tv_sec - antes;
+        s_boot_deslocamento = s_boot;
+        s_tem_deslocamento = true;
+    }
+    s_sincronizado_em = (uint32_t)tv->tv_sec;
+    portEXIT_CRITICAL(&s_lock);
+    ESP_LOGI(TAG, "Relógio acertado pelo SNTP: %u.", (unsigned)tv->tv_sec);
+}
+
+void clock_sync_start(const char *servidor) {
+    if (s_iniciado) return;
+    s_iniciado = true;
+    s_sntp_inicio_us = esp_timer_get_time();
+    // No deep sleep o relógio continua valendo; não precisa consultar o servidor a cada despertar.
+    if (relogio_valido() && (uint32_t)time(NULL) - s_sincronizado_em < CLOCK_SYNC_RESYNC_S) return;
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG(servidor);
+    config.sync_cb = ao_sincronizar;
+    esp_err_t err = esp_netif_sntp_init(&config);
+    if (err != ESP_OK) ESP_LOGW(TAG, "Falha ao iniciar o SNTP: %s", esp_err_to_name(err));
+}
+
+uint8_t clock_sync_boot(void) {
+    return s_boot;
+}
+
+bool clock_sync_fix(telemetry_reading_t *leitura) {
+    if (leitura->timestamp >= CLOCK_SYNC_EPOCH_MIN) return true;
+    portENTER_CRITICAL(&s_lock);
+    bool corrigir = s_tem_deslocamento && leitura->boot == s_boot_deslocamento;
+    uint32_t deslocamento = s_deslocamento;
+    portEXIT_CRITICAL(&s_lock);
+    if (corrigir) leitura->timestamp += deslocamento;
+    return corrigir;
+}
+
+bool clock_sync_pending(void) {
+    if (relogio_valido()) return false;
+    return !s_iniciado || esp_timer_get_time() - s_sntp_inicio_us < (int64_t)CLOCK_SYNC_ESPERA_MS * 1000;
+}
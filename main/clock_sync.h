@@ -0,0 +1,33 @@
+#pragma once
+
+// Horário de calendário para as leituras. Sem RTC com bateria, o relógio do sistema conta desde a
+// energização até o SNTP acertá-lo (ele continua contando no deep sleep). Cada leitura leva o
+// número do boot em que foi feita; quando o relógio é acertado, o deslocamento entre os dois
+// relógios vale para todas as leituras desse boot, inclusive as que esperam na flash.
+// Leituras de um boot que nunca sincronizou ficam com os segundos desde a energização (abaixo de
+// CLOCK_SYNC_EPOCH_MIN), para quem recebe poder distingui-las.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "telemetry.h"
+
+#define CLOCK_SYNC_EPOCH_MIN    1700000000u // Nov/2023: abaixo disso o relógio ainda não foi acertado.
+#define CLOCK_SYNC_ESPERA_MS    30000       // Quanto tempo após o IP ainda se espera pelo SNTP.
+#define CLOCK_SYNC_RESYNC_S     (6 * 3600)  // Ao acordar do deep sleep, só consulta o SNTP depois disso.
+
+// Conta o boot na NVS (o despertar do deep sleep continua o mesmo boot). Chamar após nvs_flash_init.
+esp_err_t clock_sync_init(void);
+
+// Inicia o SNTP; chamado quando a rede obtém IP.
+void clock_sync_start(const char *servidor);
+
+uint8_t clock_sync_boot(void);
+
+// Converte o horário da leitura para o calendário quando possível. Retorna false se ele continua
+// contado desde a energização.
+bool clock_sync_fix(telemetry_reading_t *leitura);
+
+// True enquanto o relógio não foi acertado mas o SNTP ainda pode responder: quem publica
+// horários pode segurar as leituras até lá.
+bool clock_sync_pending(void);
@@ -0,0 +1,169 @@
+#include "history.h"
+#include <stdio.h>
+#include <string.h>
+
+static const uint32_t PERIODOS[HISTORY_TIERS] = {
+    [HISTORY_RAW] = 0,
+    [HISTORY_MINUTE] = 60,
+    [HISTORY_HOUR] = 3600,
+    [HISTORY_DAY] = 86400,
+};
+
+static const uint16_t CAPACIDADES[HISTORY_TIERS] = {
+    [HISTORY_RAW] = HISTORY_RAW_SLOTS,
+    [HISTORY_MINUTE] = HISTORY_MINUTE_SLOTS,
+    [HISTORY_HOUR] = HISTORY_HOUR_SLOTS,
+    [HISTORY_DAY] = HISTORY_DAY_SLOTS,
+};
+
+static history_agg_t *agregados(history_t *h, history_tier_t nivel) {
+    switch (nivel) {
+    case HISTORY_MINUTE: return h->minutos;
+    case HISTORY_HOUR: return h->horas;
+    default: return h->dias;
+    }
+}
+
+static const history_agg_t *agregados_const(const history_t *h, history_tier_t nivel) {
+    return agregados((history_t *)h, nivel);
+}
+
+// Reserva a próxima posição do anel, descartando o registro mais antigo se estiver cheio.
+static uint16_t anel_push(history_ring_t *anel, uint16_t capacidade) {
+    uint16_t pos = (uint16_t)((anel->inicio + anel->n) % capacidade);
+    anel->total++;
+    if (anel->n < capacidade) {
+        anel->n++;
+    } else {
+        anel->inicio = (uint16_t)((anel->inicio + 1) % capacidade);
+    }
+    return pos;
+}
+
+static history_agg_t fechar(const history_acc_t *acc) {
+    history_agg_t agg = {
+        .inicio = acc->inicio,
+        .min = acc->min,
+        .max = acc->max,
+        .media = (uint8_t)((acc->soma + acc->n / 2) / acc->n),
+        .n = acc->n > 255 ? 255 : (uint8_t)acc->n,
+    };
+    return agg;
+}
+
+void history_init(history_t *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+uint32_t history_tier_period(history_tier_t nivel) {
+    return nivel < HISTORY_TIERS ? PERIODOS[nivel] : 0;
+}
+
+void history_add(history_t *h, uint32_t timestamp, uint16_t raw, uint8_t percent, bool seco) {
+    uint16_t pos = anel_push(&h->aneis[HISTORY_RAW], HISTORY_RAW_SLOTS);
+    h->bruto[pos] = (history_raw_t){ .timestamp = timestamp, .raw = raw, .percent = percent, .seco = seco };
+
+    for (history_tier_t nivel = HISTORY_MINUTE; nivel < HISTORY_TIERS; nivel++) {
+        history_acc_t *acc = &h->acumuladores[nivel];
+        uint32_t inicio = timestamp - timestamp % PERIODOS[nivel];
+        if (acc->n > 0 && acc->inicio != inicio) {
+            // Começou outro período: o anterior vai para o anel.
+            pos = anel_push(&h->aneis[nivel], CAPACIDADES[nivel]);
+            agregados(h, nivel)[pos] = fechar(acc);
+            acc->n = 0;
+        }
+        if (acc->n == 0) {
+            acc->inicio = inicio;
+            acc->soma = 0;
+            acc->min = percent;
+            acc->max = percent;
+        }
+        acc->soma += percent;
+        acc->n++;
+        if (percent < acc->min) acc->min = percent;
+        if (percent > acc->max) acc->max = percent;
+    }
+}
+
+size_t history_query(const history_t *h, history_tier_t nivel, uint32_t de, uint32_t ate, uint32_t *cursor,
+                     history_entry_t *saida, size_t max) {
+    if (nivel >= HISTORY_TIERS || max == 0) return 0;
+    const history_ring_t *anel = &h->aneis[nivel];
+    size_t n = 0;
+
+    // Começa no cursor; se ele já saiu do anel (ou é 0), começa no registro mais antigo.
+    uint32_t mais_antigo = anel->total - anel->n;
+    uint16_t i = 0;
+    if (*cursor - mais_antigo <= anel->n) i = (uint16_t)(*cursor - mais_antigo);
+    for (; i < anel->n && n < max; i++) {
+        uint16_t pos = (uint16_t)((anel->inicio + i) % CAPACIDADES[nivel]);
+        history_entry_t e = {0};
+        if (nivel == HISTORY_RAW) {
+            const history_raw_t *r = &h->bruto[pos];
+            e.timestamp = r->timestamp;
+            e.raw = r->raw;
+            e.min = e.max = e.media = r->percent;
+            e.n = 1;
+            e.seco = r->seco;
+        } else {
+            const history_agg_t *a = &agregados_const(h, nivel)[pos];
+            e.timestamp = a->inicio;
+            e.min = a->min;
+            e.max = a->max;
+            e.media = a->media;
+            e.n = a->n;
+        }
+        if (e.timestamp > ate) {
+            *cursor = mais_antigo + i;
+            return n;
+        }
+        if (e.timestamp >= de) saida[n++] = e;
+    }
+    *cursor = mais_antigo + i;
+
+    const history_acc_t *acc = &h->acumuladores[nivel];
+    if (nivel != HISTORY_RAW && n < max && acc->n > 0 && acc->inicio >= de && acc->inicio <= ate) {
+        history_agg_t agg = fechar(acc);
+        saida[n++] = (history_entry_t){
+            .timestamp = agg.inicio, .min = agg.min, .max = agg.max, .media = agg.media, .n = agg.n, .parcial = true,
+        };
+    }
+    return n;
+}
+
+static void escrever_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+size_t history_format(const history_entry_t *registros, size_t n, history_tier_t nivel, bool binario, char *saida,
+                      size_t len) {
+    size_t usado = 0;
+    for (size_t i = 0; i < n && usado + HISTORY_FORMAT_MAX <= len; i++) {
+        const history_entry_t *e = &registros[i];
+        if (binario) {
+            uint8_t *p = (uint8_t *)saida + usado;
+            escrever_u32(p, e->timestamp);
+            if (nivel == HISTORY_RAW) {
+                p[4] = (uint8_t)e->raw;
+                p[5] = (uint8_t)(e->raw >> 8);
+                p[6] = e->media;
+                p[7] = e->seco;
+            } else {
+                p[4] = e->min;
+                p[5] = e->max;
+                p[6] = e->media;
+                p[7] = e->n;
+            }
+            usado += 8;
+        } else if (nivel == HISTORY_RAW) {
+            usado += snprintf(saida + usado, len - usado, "%u,%u,%u,%d\n", (unsigned)e->timestamp, e->raw, e->media, e->seco);
+        } else {
+            usado += snprintf(saida + usado, len - usado, "%u,%u,%u,%u,%u,%d\n", (unsigned)e->timestamp, e->min, e->max,
+                              e->media, e->n, e->parcial);
+        }
+    }
+    return usado;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+// Histórico das leituras em RAM, com memória fixa, em vários níveis de resolução:
+// as leituras brutas mais recentes e, para períodos mais longos, mínimo/máximo/média da
+// umidade por minuto, hora e dia. Cada leitura atualiza os acumuladores de todos os níveis
+// na hora, sem reprocessar o que já foi guardado.
+// Este módulo não depende do ESP-IDF para poder ser compilado e testado no computador.
+//
+// Memória por sensor: (HISTORY_RAW_SLOTS + HISTORY_MINUTE_SLOTS + HISTORY_HOUR_SLOTS
+//                      + HISTORY_DAY_SLOTS) * 8 bytes, mais os acumuladores (~5,5 KB).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// O nível bruto guarda as últimas leituras, não um período fixo: cada varredura acrescenta uma, então
+// ele cobre HISTORY_RAW_SLOTS vezes o intervalo entre varreduras. São 2 horas a cada 30 s, mas com a
+// amostragem adaptativa vai de 20 minutos durante uma rega (a cada 5 s) a 20 horas com o solo estável
+// (a cada 300 s). Os níveis agregados só guardam períodos com leitura, então cobrem pelo menos o
+// período indicado (mais, se as leituras forem mais espaçadas que o período).
+#define HISTORY_RAW_SLOTS       240
+#define HISTORY_MINUTE_SLOTS    180   // 3 horas.
+#define HISTORY_HOUR_SLOTS      168   // 7 dias.
+#define HISTORY_DAY_SLOTS       90    // 90 dias.
+
+#define HISTORY_FORMAT_MAX      48    // Bytes por registro formatado, com folga (CSV ou binário).
+
+typedef enum {
+    HISTORY_RAW,
+    HISTORY_MINUTE,
+    HISTORY_HOUR,
+    HISTORY_DAY,
+    HISTORY_TIERS,
+} history_tier_t;
+
+// Registro guardado no nível bruto (8 bytes).
+typedef struct {
+    uint32_t timestamp;
+    uint16_t raw;
+    uint8_t percent;
+    uint8_t seco;
+} history_raw_t;
+
+// Registro guardado nos níveis agregados (8 bytes); percent em %.
+typedef struct {
+    uint32_t inicio;    // Início do período.
+    uint8_t min;
+    uint8_t max;
+    uint8_t media;
+    uint8_t n;          // Leituras no período (satura em 255).
+} history_agg_t;
+
+typedef struct {
+    uint32_t inicio;
+    uint32_t soma;
+    uint32_t n;
+    uint8_t min;
+    uint8_t max;
+} history_acc_t;
+
+typedef struct {
+    uint16_t inicio;    // Posição do registro mais antigo.
+    uint16_t n;
+    uint32_t total;     // Registros já gravados desde history_init (índice do próximo).
+} history_ring_t;
+
+typedef struct {
+    history_raw_t bruto[HISTORY_RAW_SLOTS];
+    history_agg_t minutos[HISTORY_MINUTE_SLOTS];
+    history_agg_t horas[HISTORY_HOUR_SLOTS];
+    history_agg_t dias[HISTORY_DAY_SLOTS];
+    history_ring_t aneis[HISTORY_TIERS];
+    history_acc_t acumuladores[HISTORY_TIERS]; // O nível bruto não usa acumulador.
+} history_t;
+
+// Resultado de uma consulta, no mesmo formato para todos os níveis.
+typedef struct {
+    uint32_t timestamp;  // Instante da leitura (bruto) ou início do período.
+    uint16_t raw;        // Só no nível bruto.
+    uint8_t min;
+    uint8_t max;
+    uint8_t media;       // No nível bruto, min = max = media = porcentagem da leitura.
+    uint8_t n;
+    bool seco;           // Só no nível bruto.
+    bool parcial;        // Período ainda em andamento (valor do acumulador).
+} history_entry_t;
+
+void history_init(history_t *h);
+
+// Duração de um período do nível, em segundos (0 no nível bruto).
+uint32_t history_tier_period(history_tier_t nivel);
+
+// Acrescenta uma leitura a todos os níveis. Os timestamps devem ser crescentes.
+void history_add(history_t *h, uint32_t timestamp, uint16_t raw, uint8_t percent, bool seco);
+
+// Copia até max registros do nível com timestamp em [de, ate], do mais antigo para o mais novo,
+// a partir do registro de índice *cursor (contado desde history_init; 0 desde o começo).
+// O período em andamento entra por último, marcado como parcial.
+// Na volta, *cursor aponta para depois do último registro examinado: para continuar a consulta,
+// chame de novo com o mesmo cursor. Como a paginação é por índice, leituras com o mesmo
+// timestamp não se perdem entre blocos, e leituras novas no meio da consulta não se repetem.
+size_t history_query(const history_t *h, history_tier_t nivel, uint32_t de, uint32_t ate, uint32_t *cursor,
+                     history_entry_t *saida, size_t max);
+
+// Formata n registros de uma consulta em CSV (uma linha por registro) ou no formato binário de
+// 8 bytes descrito em history_server.h. Para antes de passar de len; devolve os bytes usados.
+size_t history_format(const history_entry_t *registros, size_t n, history_tier_t nivel, bool binario, char *saida,
+                      size_t len);
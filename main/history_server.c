@@ -0,0 +1,155 @@
+#include "history_server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "history.h"
+#include "metrics.h"
+
+static const char *TAG = "HISTORICO";
+
+static const char *NIVEIS[HISTORY_TIERS] = {
+    [HISTORY_RAW] = "bruto",
+    [HISTORY_MINUTE] = "minuto",
+    [HISTORY_HOUR] = "hora",
+    [HISTORY_DAY] = "dia",
+};
+
+static history_t *s_historicos;
+static size_t s_n_sensores;
+static SemaphoreHandle_t s_mutex;
+static httpd_handle_t s_servidor;
+
+esp_err_t history_server_init(size_t n_sensores) {
+    s_historicos = calloc(n_sensores, sizeof(history_t));
+    s_mutex = xSemaphoreCreateMutex();
+    if (s_historicos == NULL || s_mutex == NULL) return ESP_ERR_NO_MEM;
+    for (size_t i = 0; i < n_sensores; i++) {
+        history_init(&s_historicos[i]);
+    }
+    s_n_sensores = n_sensores;
+    ESP_LOGI(TAG, "Histórico em RAM: %u bytes por vaso, %u no total.", (unsigned)sizeof(history_t),
+             (unsigned)history_server_memory());
+    return ESP_OK;
+}
+
+void history_server_add(const telemetry_reading_t *leitura) {
+    if (leitura->sensor >= s_n_sensores) return;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    history_add(&s_historicos[leitura->sensor], leitura->timestamp, leitura->raw, leitura->percent, leitura->seco);
+    xSemaphoreGive(s_mutex);
+}
+
+size_t history_server_memory(void) {
+    return s_n_sensores * sizeof(history_t);
+}
+
+// Lê um parâmetro de texto. Ausente mantém o padrão; longo demais para o buffer é inválido.
+static bool parametro_texto(const char *query, const char *chave, char *texto, size_t len, bool *presente) {
+    esp_err_t err = httpd_query_key_value(query, chave, texto, len);
+    *presente = err == ESP_OK;
+    return err == ESP_OK || err == ESP_ERR_NOT_FOUND;
+}
+
+// Só dígitos decimais, até UINT32_MAX (strtoul aceitaria espaços, sinal e estouro).
+static bool parametro_uint(const char *query, const char *chave, uint32_t *valor) {
+    char texto[12];
+    bool presente;
+    if (!parametro_texto(query, chave, texto, sizeof(texto), &presente)) return false;
+    if (!presente) return true;
+    if (texto[0] == '\0') return false;
+    uint64_t v = 0;
+    for (const char *c = texto; *c != '\0'; c++) {
+        if (*c < '0' || *c > '9') return false;
+        v = v * 10 + (uint64_t)(*c - '0');
+        if (v > UINT32_MAX) return false;
+    }
+    *valor = (uint32_t)v;
+    return true;
+}
+
+static esp_err_t historico_get(httpd_req_t *req) {
+    int64_t inicio_us = metrics_start();
+    char query[96] = "";
+    char texto[8];
+    uint32_t sensor = 0, de = 0, ate = UINT32_MAX;
+    history_tier_t nivel = HISTORY_HOUR;
+    bool binario = false;
+
+    bool presente;
+    esp_err_t err = httpd_req_get_url_query_str(req, query, sizeof(query));
+    if (err != ESP_OK && err != ESP_ERR_NOT_FOUND) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "consulta longa demais");
+    }
+    if (!parametro_uint(query, "sensor", &sensor) || !parametro_uint(query, "de", &de) ||
+        !parametro_uint(query, "ate", &ate) || sensor >= s_n_sensores || de > ate) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "sensor, de ou ate invalido");
+    }
+    bool nivel_ok = parametro_texto(query, "nivel", texto, sizeof(texto), &presente);
+    if (nivel_ok && presente) {
+        for (nivel = 0; nivel < HISTORY_TIERS && strcmp(texto, NIVEIS[nivel]) != 0; nivel++) {
+        }
+        nivel_ok = nivel < HISTORY_TIERS;
+    }
+    if (!nivel_ok) return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "nivel: bruto, minuto, hora ou dia");
+    if (!parametro_texto(query, "formato", texto, sizeof(texto), &presente) ||
+        (presente && strcmp(texto, "bin") != 0 && strcmp(texto, "csv") != 0)) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "formato: csv ou bin");
+    }
+    binario = presente && strcmp(texto, "bin") == 0;
+
+    // O cabeçalho precisa continuar válido até o primeiro pedaço ser enviado.
+    char agora[12];
+    snprintf(agora, sizeof(agora), "%u", (unsigned)time(NULL));
+    httpd_resp_set_hdr(req, "X-Agora", agora);
+    httpd_resp_set_type(req, binario ? "application/octet-stream" : "text/csv");
+
+    if (!binario) {
+        const char *cabecalho = nivel == HISTORY_RAW ? "timestamp,raw,umidade,seco\n" : "inicio,min,max,media,leituras,parcial\n";
+        err = httpd_resp_sendstr_chunk(req, cabecalho);
+    }
+
+    // Copia um bloco sob o mutex e formata/envia fora dele; a próxima cópia continua do cursor
+    // (índice no anel), então leituras novas no meio da resposta não causam repetição nem perda.
+    history_entry_t bloco[HISTORY_SERVER_BLOCO];
+    char pedaco[HISTORY_SERVER_BLOCO * HISTORY_FORMAT_MAX];
+    size_t registros = 0;
+    uint32_t cursor = 0;
+    while (err == ESP_OK) {
+        xSemaphoreTake(s_mutex, portMAX_DELAY);
+        size_t n = history_query(&s_historicos[sensor], nivel, de, ate, &cursor, bloco, HISTORY_SERVER_BLOCO);
+        xSemaphoreGive(s_mutex);
+        if (n == 0) break;
+        size_t len = history_format(bloco, n, nivel, binario, pedaco, sizeof(pedaco));
+        err = httpd_resp_send_chunk(req, pedaco, len);
+        registros += n;
+        // O período parcial é sempre o último registro; um bloco incompleto também encerra a consulta.
+        if (n < HISTORY_SERVER_BLOCO || bloco[n - 1].parcial) break;
+    }
+    if (err == ESP_OK) err = httpd_resp_send_chunk(req, NULL, 0);
+    metrics_record_since(METRIC_HTTP_REQUEST, inicio_us);
+    ESP_LOGD(TAG, "%s do sensor %u: %u registros.", NIVEIS[nivel], (unsigned)sensor, (unsigned)registros);
+    return err;
+}
+
+esp_err_t history_server_start(uint16_t porta) {
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = porta;
+    config.max_open_sockets = 3; // Poucos clientes na rede local; cada socket reserva memória.
+    config.lru_purge_enable = true;
+    esp_err_t err = httpd_start(&s_servidor, &config);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Falha ao iniciar o servidor HTTP: %s", esp_err_to_name(err));
+        return err;
+    }
+    static const httpd_uri_t rota = {
+        .uri = "/historico",
+        .method = HTTP_GET,
+        .handler = historico_get,
+    };
+    return httpd_register_uri_handler(s_servidor, &rota);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// Guarda o histórico de cada vaso em RAM (ver history.h) e o serve na rede local por HTTP:
+//   GET /historico?sensor=0&nivel=hora&de=<s>&ate=<s>&formato=csv
+//     nivel:   bruto, minuto, hora (padrão) ou dia
+//     de, ate: segundos do relógio do sistema (padrão: tudo); o cabeçalho X-Agora traz o relógio atual
+//     formato: csv (padrão) ou bin
+// A resposta é enviada em pedaços (chunked) de poucos registros por vez, copiados sob o mutex,
+// então nem a resposta inteira fica na memória nem a gravação das leituras espera a rede.
+//
+// Formato binário: registros de 8 bytes, little-endian, sem cabeçalho:
+//   bruto:     timestamp u32, raw u16, umidade u8, seco u8
+//   agregados: início u32, mínimo u8, máximo u8, média u8, leituras u8
+// O período ainda em andamento é sempre o último registro (no CSV, com parcial=1).
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "telemetry.h"
+
+#define HISTORY_SERVER_PORTA        80
+#define HISTORY_SERVER_BLOCO        16    // Registros copiados e enviados por pedaço.
+
+// Reserva o histórico dos n primeiros vasos.
+esp_err_t history_server_init(size_t n_sensores);
+
+// Acrescenta uma leitura ao histórico do vaso leitura->sensor.
+void history_server_add(const telemetry_reading_t *leitura);
+
+// Inicia o servidor HTTP (exige a rede já iniciada).
+esp_err_t history_server_start(uint16_t porta);
+
+// Bytes de RAM ocupados pelo histórico de todos os vasos.
+size_t history_server_memory(void);
@@ -0,0 +1,124 @@
+#include "low_power.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "LOW_POWER";
+
+typedef struct {
+    bool valido;
+    uint8_t bssid[6];
+    uint8_t canal;
+    esp_netif_ip_info_t ip;
+    esp_netif_dns_info_t dns;
+} wifi_cache_t;
+
+// Sobrevivem ao deep sleep (são zeradas apenas na energização).
+static RTC_DATA_ATTR wifi_cache_t s_wifi_cache;
+static RTC_DATA_ATTR uint32_t s_despertares;
+static RTC_DATA_ATTR uint32_t s_ultimo_acordado_ms;
+static RTC_DATA_ATTR uint32_t s_ultimo_sono_ms;
+
+static esp_netif_t *s_netif;
+static wifi_config_t *s_wifi_config;
+static bool s_usando_cache;
+static int64_t s_publicado_us = -1;
+// O PUBACK pode chegar antes de low_power_expect_publish receber o msg_id: os últimos ficam guardados.
+#define LOW_POWER_ACKS 8
+static portMUX_TYPE s_ack_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_msg_id_leitura = -1;
+static int s_acks[LOW_POWER_ACKS];
+static int64_t s_acks_us[LOW_POWER_ACKS];
+static size_t s_n_acks;
+
+bool low_power_woke_from_sleep(void) {
+    return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+}
+
+void low_power_apply_wifi_cache(esp_netif_t *netif, wifi_config_t *wifi_config) {
+    s_netif = netif;
+    s_wifi_config = wifi_config;
+    if (!low_power_woke_from_sleep() || !s_wifi_cache.valido) return;
+
+    // Conecta direto no AP conhecido, sem varrer os canais, e pula o DHCP.
+    wifi_config->sta.bssid_set = true;
+    memcpy(wifi_config->sta.bssid, s_wifi_cache.bssid, sizeof(s_wifi_cache.bssid));
+    wifi_config->sta.channel = s_wifi_cache.canal;
+    esp_netif_dhcpc_stop(netif);
+    esp_netif_set_ip_info(netif, &s_wifi_cache.ip);
+    esp_netif_set_dns_info(netif, ESP_NETIF_DNS_MAIN, &s_wifi_cache.dns);
+    s_usando_cache = true;
+    ESP_LOGI(TAG, "Reconectando com AP/IP guardados (canal %d).", s_wifi_cache.canal);
+}
+
+void low_power_save_wifi_cache(esp_netif_t *netif, const esp_netif_ip_info_t *ip_info) {
+    if (s_usando_cache) return;
+    wifi_ap_record_t ap;
+    if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK) return;
+    memcpy(s_wifi_cache.bssid, ap.bssid, sizeof(s_wifi_cache.bssid));
+    s_wifi_cache.canal = ap.primary;
+    s_wifi_cache.ip = *ip_info;
+    esp_netif_get_dns_info(netif, ESP_NETIF_DNS_MAIN, &s_wifi_cache.dns);
+    s_wifi_cache.valido = true;
+}
+
+void low_power_invalidate_wifi_cache(void) {
+    if (!s_usando_cache) return;
+    ESP_LOGW(TAG, "Falha com o AP/IP guardados. Voltando para varredura e DHCP.");
+    s_wifi_cache.valido = false;
+    s_usando_cache = false;
+    s_wifi_config->sta.bssid_set = false;
+    s_wifi_config->sta.channel = 0;
+    esp_wifi_set_config(WIFI_IF_STA, s_wifi_config);
+    esp_netif_dhcpc_start(s_netif);
+}
+
+void low_power_expect_publish(int msg_id) {
+    if (msg_id < 0) return;
+    portENTER_CRITICAL(&s_ack_lock);
+    s_msg_id_leitura = msg_id;
+    for (size_t i = 0; i < s_n_acks && i < LOW_POWER_ACKS; i++) {
+        if (s_acks[i] == msg_id && s_publicado_us < 0) s_publicado_us = s_acks_us[i];
+    }
+    portEXIT_CRITICAL(&s_ack_lock);
+}
+
+void low_power_on_published(int msg_id) {
+    int64_t agora_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_ack_lock);
+    if (msg_id >= 0 && msg_id == s_msg_id_leitura) {
+        if (s_publicado_us < 0) s_publicado_us = agora_us;
+    } else {
+        s_acks[s_n_acks % LOW_POWER_ACKS] = msg_id;
+        s_acks_us[s_n_acks % LOW_POWER_ACKS] = agora_us;
+        s_n_acks++;
+    }
+    portEXIT_CRITICAL(&s_ack_lock);
+}
+
+void low_power_get_report(low_power_report_t *report) {
+    // mW * ms = uJ; dividindo por 1000 chega em mJ.
+    uint64_t ativo_uj = (uint64_t)LOW_POWER_TENSAO_MV * LOW_POWER_CORRENTE_ATIVO_MA * s_ultimo_acordado_ms / 1000;
+    uint64_t sono_uj = (uint64_t)LOW_POWER_TENSAO_MV * LOW_POWER_CORRENTE_SONO_UA * s_ultimo_sono_ms / 1000000;
+    uint64_t ligado_uj = (uint64_t)LOW_POWER_TENSAO_MV * LOW_POWER_CORRENTE_OCIOSO_MA * (s_ultimo_acordado_ms + s_ultimo_sono_ms) / 1000;
+
+    report->despertares = s_despertares;
+    report->acordado_ms = s_ultimo_acordado_ms;
+    report->publicacao_ms = s_publicado_us < 0 ? 0 : (uint32_t)(s_publicado_us / 1000);
+    report->energia_est_mj = (uint32_t)((ativo_uj + sono_uj) / 1000);
+    report->energia_sempre_ligado_est_mj = (uint32_t)(ligado_uj / 1000);
+    report->wifi_rapido = s_usando_cache;
+}
+
+void low_power_sleep(uint32_t intervalo_ms) {
+    esp_wifi_stop();
+    s_despertares++;
+    s_ultimo_acordado_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    s_ultimo_sono_ms = intervalo_ms;
+    ESP_LOGI(TAG, "Acordado por %u ms. Dormindo por %u ms.", (unsigned)s_ultimo_acordado_ms, (unsigned)intervalo_ms);
+    esp_sleep_enable_timer_wakeup((uint64_t)intervalo_ms * 1000);
+    esp_deep_sleep_start();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Modo de baixo consumo: o dispositivo lê, publica e dorme em deep sleep até a próxima leitura.
+// Guarda em memória RTC o AP (BSSID/canal) e o IP da última conexão para reconectar sem
+// varredura nem DHCP, e estima a energia gasta em cada despertar.
+// A energia não é medida: é o tempo acordado e dormindo multiplicado pelas correntes típicas abaixo.
+// Os tempos são medidos; para um valor real de energia, meça a corrente da sua placa e ajuste aqui.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_netif.h"
+#include "esp_wifi.h"
+
+// Correntes supostas na estimativa do relatório (ajuste conforme a medição da sua placa).
+#define LOW_POWER_TENSAO_MV           3300
+#define LOW_POWER_CORRENTE_ATIVO_MA   120  // Média com o rádio Wi-Fi ligado.
+#define LOW_POWER_CORRENTE_SONO_UA    10   // Deep sleep com o timer RTC.
+#define LOW_POWER_CORRENTE_OCIOSO_MA  40   // Loop sempre ligado, com modem sleep, entre leituras.
+
+typedef struct {
+    uint32_t despertares;
+    uint32_t acordado_ms;        // Tempo acordado no despertar anterior (completo).
+    uint32_t publicacao_ms;      // Do boot até o PUBACK da leitura deste despertar (0 se não houve).
+    uint32_t energia_est_mj;     // Estimativa do ciclo anterior (acordado + dormindo), não medida.
+    uint32_t energia_sempre_ligado_est_mj; // Mesmo intervalo no loop sempre ligado, para comparação.
+    bool wifi_rapido;            // Este despertar usou o AP/IP guardados.
+} low_power_report_t;
+
+// True se o boot atual é um despertar do deep sleep (e não uma energização ou reset).
+bool low_power_woke_from_sleep(void);
+
+// Preenche BSSID/canal e configura IP fixo com os dados guardados, se houver.
+void low_power_apply_wifi_cache(esp_netif_t *netif, wifi_config_t *wifi_config);
+
+// Guarda AP e IP após uma conexão obtida pelo caminho normal (varredura + DHCP).
+void low_power_save_wifi_cache(esp_netif_t *netif, const esp_netif_ip_info_t *ip_info);
+
+// Chamado quando a conexão falha: descarta o cache e volta para varredura + DHCP.
+void low_power_invalidate_wifi_cache(void);
+
+// Informa o msg_id da publicação que leva a leitura deste despertar (-1 se ela não saiu agora).
+// publicacao_ms passa a ser o instante do PUBACK desse msg_id e fica 0 se ele não chegar.
+void low_power_expect_publish(int msg_id);
+
+// Deve ser chamada pelo handler de eventos MQTT em MQTT_EVENT_PUBLISHED.
+void low_power_on_published(int msg_id);
+
+void low_power_get_report(low_power_report_t *report);
+
+// Desliga o rádio e entra em deep sleep por intervalo_ms. Não retorna.
+void low_power_sleep(uint32_t intervalo_ms);
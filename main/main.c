@@ -1,220 +1,188 @@
 #include <stdio.h>
 #include <string.h>
-#include <ctype.h>
+#include <time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
-#include "driver/gpio.h"
-#include "driver/adc.h"
 #include "nvs_flash.h"
 #include "nvs.h" // Biblioteca para salvar na memória não-volátil
-#include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_attr.h"
 #include "mqtt_client.h"
-#include "esp_http_client.h"
-#include "esp_tls.h"
-#include "esp_crt_bundle.h"
+#include "esp_timer.h"
+#include "sensor_adc.h"
+#include "telemetry.h"
+#include "store_forward.h"
+#include "telegram_notifier.h"
+#include "clock_sync.h"
+#include "sensor_table.h"
+#include "remote_config.h"
+#include "metrics.h"
+#include "history_server.h"
+#include "adaptive_sampling.h"
+#include "sensor_filter.h"
+#include "board.h"
+#include "low_power.h"
 
 // CONFIGURAÇÕES DE REDE
 #define WIFI_SSID           "NOME_DA_SUA_REDE_WIFI"
 #define WIFI_PASS           "SENHA_DA_SUA_REDE_WIFI"
+#define SNTP_SERVIDOR       "pool.ntp.org" // Acerta o relógio usado nos horários das leituras.
 // Configurações Telegram são opcionais. Deixe em branco se não for usar
 #define TELEGRAM_TOKEN      ""
 #define TELEGRAM_CHAT_ID    ""
+#define TELEGRAM_API_URL    "https://api.telegram.org" // Pode apontar para um servidor HTTPS local em testes.
+#define TELEGRAM_CERT_PEM   NULL // Certificado do servidor local (tools/telegram_local.py); NULL usa o bundle de CAs.
 
 // CONFIGURAÇÕES DO PROTOCOLO MQTT 
 #define MQTT_BROKER_URL     "mqtt://broker.hivemq.com"
 #define MQTT_BASE_TOPIC     "soloscan/planta"
-#define MQTT_TOPIC_STATUS   MQTT_BASE_TOPIC "/status"
-#define MQTT_TOPIC_LEITURA  MQTT_BASE_TOPIC "/leitura_raw"
-#define MQTT_TOPIC_PERCENT  MQTT_BASE_TOPIC "/umidade_percentual"
-#define MQTT_TOPIC_ALERTA   MQTT_BASE_TOPIC "/alerta"
-#define MQTT_TOPIC_SET_TIPO MQTT_BASE_TOPIC "/set_tipo"
+// Tópicos de cada vaso: tópico base + sufixo do sensor + um dos sufixos abaixo.
+#define MQTT_SUFIXO_STATUS   "/status"
+#define MQTT_SUFIXO_LEITURA  "/leitura_raw"
+#define MQTT_SUFIXO_PERCENT  "/umidade_percentual"
+#define MQTT_SUFIXO_ALERTA   "/alerta"
+// Tópicos do dispositivo inteiro.
+#define MQTT_TOPIC_LEITURAS   MQTT_BASE_TOPIC "/leituras"
+#define MQTT_TOPIC_TELEMETRIA MQTT_BASE_TOPIC "/telemetria"
+#define MQTT_TOPIC_ENERGIA    MQTT_BASE_TOPIC "/energia"
+#define MQTT_TOPIC_METRICAS   MQTT_BASE_TOPIC "/metrics"
+
+#define INTERVALO_LEITURA_MS 30000 // Padrão; pode ser alterado por MQTT (tópico /config).
+#define METRICAS_INTERVALO_S 300   // Intervalo entre relatórios de latência, memória e stack em /metrics.
+
+// MODO DE BAIXO CONSUMO (opcional): em vez de ficar ligado entre as leituras, o ESP32 lê,
+// publica e entra em deep sleep por INTERVALO_LEITURA_MS. Um relatório de tempo acordado e
+// energia estimada (não medida; ver main/low_power.h) é publicado em /energia a cada despertar.
+#define MODO_BAIXO_CONSUMO  0
+#define BAIXO_CONSUMO_MAX_ACORDADO_MS 15000 // Tempo máximo esperando conexão e confirmações.
+
+// TELEMETRIA BINÁRIA (opcional): agrupa as leituras em um único quadro no tópico /telemetria
+// em vez de publicar leitura_raw e umidade_percentual em texto a cada ciclo.
+#define TELEMETRIA_BINARIA      0
+#define TELEMETRIA_LOTE         10      // Leituras por quadro (máximo TELEMETRY_MAX_READINGS).
+#define TELEMETRIA_FLUSH_S      300     // Envia o quadro mesmo incompleto após esse tempo.
+
+// AMOSTRAGEM ADAPTATIVA: lê a cada AMOSTRAGEM_MIN_MS enquanto a umidade muda rápido (rega) e
+// espaça as leituras até AMOSTRAGEM_MAX_MS com o solo estável; a leitura só é publicada quando
+// anda mais que a banda morta, quando o estado muda ou a cada AMOSTRAGEM_HEARTBEAT_S.
+// Desligada, lê e publica a cada INTERVALO_LEITURA_MS. Use tools/amostragem_replay.c para comparar.
+#define AMOSTRAGEM_ADAPTATIVA       1
+#define AMOSTRAGEM_MIN_MS           5000
+#define AMOSTRAGEM_MAX_MS           300000
+#define AMOSTRAGEM_DERIVADA_RAPIDA  120     // %/h (2% por minuto): acelera.
+#define AMOSTRAGEM_DERIVADA_ESTAVEL 10      // %/h: espaça.
+#define AMOSTRAGEM_BANDA_MORTA      2       // %.
+#define AMOSTRAGEM_HEARTBEAT_S      1800
+
+// ESTABILIZAÇÃO NO BOOT: a primeira leitura sai assim que as últimas SENSOR_SETTLE_JANELA
+// varreduras (uma por segundo) de todos os vasos cabem em ESTABILIZACAO_TOLERANCIA contagens do
+// ADC, ou depois de ESTABILIZACAO_MAX_MS (a antiga pausa fixa) se o sensor não estabilizar.
+#define ESTABILIZACAO_TOLERANCIA    12      // Contagens do ADC (~0,5% com a calibração padrão).
+#define ESTABILIZACAO_MAX_MS        180000
+#define BOOT_MQTT_MAX_MS            30000   // Espera pelo broker antes de mandar a primeira leitura para a flash.
+
+// HISTÓRICO LOCAL: guarda as leituras em RAM (brutas, por minuto, hora e dia) e as serve em
+// http://<ip do ESP32>/historico. Não funciona no modo de baixo consumo, que apaga a RAM ao dormir.
+#define SERVIDOR_HISTORICO      1
 
 #define SENSOR_MIN_MOLHADO  1406
 #define SENSOR_MAX_SECO     3817
 
-#define SENSOR_PIN          ADC1_CHANNEL_6 // O sensor está no pino GPIO34
+#define SENSOR_PIN          ADC_CHANNEL_6  // O sensor está no pino GPIO34 (ADC1)
 #define LED_PIN             GPIO_NUM_2     
 
+// TABELA DE SENSORES: um vaso por linha, até os 8 canais do ADC1. Todos os canais são lidos na
+// mesma varredura e as leituras do ciclo saem juntas em um único relatório.
+// O primeiro vaso usa sufixo "" para manter os tópicos originais (soloscan/planta/status, ...).
+static const sensor_config_t SENSORES[] = {
+    { .nome = "", .sufixo = "", .canal = SENSOR_PIN, .led = LED_PIN,
+      .min_molhado = SENSOR_MIN_MOLHADO, .max_seco = SENSOR_MAX_SECO, .threshold = 35, .histerese = 3 },
+    // { .nome = "vaso2", .sufixo = "/vaso2", .canal = ADC_CHANNEL_7, .led = BOARD_SEM_LED, // GPIO35
+    //   .min_molhado = SENSOR_MIN_MOLHADO, .max_seco = SENSOR_MAX_SECO, .threshold = 35, .histerese = 3 },
+};
+#define N_SENSORES (sizeof(SENSORES) / sizeof(SENSORES[0]))
+_Static_assert(N_SENSORES <= SENSOR_TABLE_MAX, "O ADC1 tem no máximo 8 canais");
+
 static const char *TAG = "SOLOSCAN_PRO"; 
 #define WIFI_CONNECTED_BIT BIT0
-#define WIFI_FAIL_BIT      BIT1
+#define MQTT_CONNECTED_BIT BIT2
 static EventGroupHandle_t s_wifi_event_group; 
 static esp_mqtt_client_handle_t mqtt_client; 
+static volatile bool s_mqtt_conectado = false;
+static bool s_mqtt_iniciado = false;
 
-static int g_threshold_percent_seco = 35;
+static RTC_DATA_ATTR bool ultimo_estado_seco[SENSOR_TABLE_MAX]; // Estado anterior de cada vaso; sobrevive ao deep sleep.
 
-// Essa função garante que a configuração persista mesmo se o dispositivo for reiniciado.
-void save_threshold_to_nvs(int threshold) {
-    nvs_handle_t my_handle;
-    esp_err_t err = nvs_open("storage", NVS_READWRITE, &my_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Erro (%s) abrindo NVS para escrita!", esp_err_to_name(err));
-    } else {
-        err = nvs_set_i32(my_handle, "threshold", threshold);
-        if(err == ESP_OK) {
-            ESP_LOGI(TAG, "Novo threshold (%d) salvo na memória NVS", threshold);
-            nvs_commit(my_handle);
-        } else {
-            ESP_LOGE(TAG, "Falha ao salvar threshold na NVS!");
-        }
-        nvs_close(my_handle);
-    }
-}
+#if AMOSTRAGEM_ADAPTATIVA
+static const adaptive_config_t AMOSTRAGEM = {
+    .intervalo_min_ms = AMOSTRAGEM_MIN_MS,
+    .intervalo_max_ms = AMOSTRAGEM_MAX_MS,
+    .derivada_rapida = AMOSTRAGEM_DERIVADA_RAPIDA,
+    .derivada_estavel = AMOSTRAGEM_DERIVADA_ESTAVEL,
+    .banda_morta = AMOSTRAGEM_BANDA_MORTA,
+    .heartbeat_s = AMOSTRAGEM_HEARTBEAT_S,
+};
+static RTC_DATA_ATTR adaptive_state_t s_amostragem[SENSOR_TABLE_MAX];
+#endif
 
-// lê o limite de alerta da memória NVS quando o ESP32 liga
-void load_threshold_from_nvs() {
-    nvs_handle_t my_handle;
-    esp_err_t err = nvs_open("storage", NVS_READONLY, &my_handle);
-    if (err != ESP_OK) {
-        ESP_LOGW(TAG, "NVS não encontrada. Usando threshold padrão (%d).", g_threshold_percent_seco);
-    } else {
-        int32_t required_value;
-        err = nvs_get_i32(my_handle, "threshold", &required_value);
-        if (err == ESP_OK) {
-            g_threshold_percent_seco = required_value;
-            ESP_LOGI(TAG, "Threshold (%d) carregado da memória NVS.", g_threshold_percent_seco);
-        } else {
-            ESP_LOGW(TAG, "Nenhum threshold salvo na memória. Usando padrão (%d).", g_threshold_percent_seco);
-        }
-        nvs_close(my_handle);
+// Chamado pela placa (na tarefa de eventos) sempre que a rede obtém IP.
+static void on_network_connected(void) {
+    xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+    clock_sync_start(SNTP_SERVIDOR);
+    // O cliente MQTT só é iniciado com IP, para a primeira tentativa não falhar e esperar o
+    // intervalo de reconexão; depois disso ele mesmo reconecta.
+    if (!s_mqtt_iniciado) {
+        s_mqtt_iniciado = true;
+        esp_mqtt_client_start(mqtt_client);
     }
 }
 
-// Converte uma string para o formato URL seguro, codificando caracteres especiais.
-void url_encode(const char *src, char *dst, size_t dst_len) {
-    size_t i = 0;
-    while (*src && i + 4 < dst_len) {
-        if (isalnum((unsigned char)*src) || *src == '-' || *src == '_' || *src == '.' || *src == '~') {
-            dst[i++] = *src;
-        } else {
-            i += snprintf(&dst[i], 4, "%%%02X", (unsigned char)*src);
-        }
-        src++;
-    }
-    dst[i] = '\0';
-}
-
-// Gerencia eventos de Wi-Fi, como reconexão automática e status de conexão.
-static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
-    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        esp_wifi_connect();
-    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
-        ESP_LOGI(TAG, "Falha ao conectar ao Wi-Fi. Tentando novamente...");
-        esp_wifi_connect();
-    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
-        ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
-        ESP_LOGI(TAG, "Conectado! Endereço IP: " IPSTR, IP2STR(&event->ip_info.ip));
-        xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
-    }
+// Publica com QoS 1, medindo o tempo gasto na chamada. len 0 publica dados como string.
+static int mqtt_publish(const char *topico, const char *dados, int len) {
+    int64_t inicio_us = metrics_start();
+    int msg_id = esp_mqtt_client_publish(mqtt_client, topico, dados, len, 1, 0);
+    metrics_record_since(METRIC_MQTT_PUBLISH, inicio_us);
+    return msg_id;
 }
 
-// Configura, inicia e aguarda a conexão Wi-Fi ser estabelecida.
-void wifi_init_sta(void) {
-    s_wifi_event_group = xEventGroupCreate();
-    ESP_ERROR_CHECK(esp_netif_init());
-    ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
-    esp_event_handler_instance_t instance_any_id;
-    esp_event_handler_instance_t instance_got_ip;
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL, &instance_any_id));
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL, &instance_got_ip));
-    wifi_config_t wifi_config = { .sta = { .ssid = WIFI_SSID, .password = WIFI_PASS, }, };
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(ESP_IF_WIFI_STA, &wifi_config));
-    ESP_ERROR_CHECK(esp_wifi_start());
-    ESP_LOGI(TAG, "Esperando pela conexão Wi-Fi...");
-    xEventGroupWaitBits(s_wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT, pdFALSE, pdFALSE, portMAX_DELAY);
-}
-
-// Envia uma notificação para o Telegram via requisição HTTP.
-void telegram_send_message(const char* message) {
-    // Verifica se as credenciais do Telegram foram preenchidas, caso contrário, pula o envio.
-    if (strcmp(TELEGRAM_TOKEN, "O_TOKEN_DO_SEU_BOT_DO_TELEGRAM") == 0 || strcmp(TELEGRAM_CHAT_ID, "O_ID_DO_SEU_CHAT_COM_O_BOT") == 0) {
-        ESP_LOGW(TAG, "Token/Chat ID do Telegram não configurado. Pulando envio.");
-        return;
-    }
-    char encoded_msg[512];
-    char url[1024];
-    url_encode(message, encoded_msg, sizeof(encoded_msg));
-    snprintf(url, sizeof(url), "https://api.telegram.org/bot%s/sendMessage?chat_id=%s&text=%s", TELEGRAM_TOKEN, TELEGRAM_CHAT_ID, encoded_msg);
-    esp_http_client_config_t config = { .url = url, .crt_bundle_attach = esp_crt_bundle_attach, };
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    esp_err_t err = esp_http_client_perform(client);
-    if (err == ESP_OK) {
-        ESP_LOGI(TAG, "Mensagem enviada para o Telegram com sucesso!");
-    } else {
-        ESP_LOGE(TAG, "Erro ao enviar mensagem para o Telegram: %s", esp_err_to_name(err));
-    }
-    esp_http_client_cleanup(client);
+// Publica um valor em um dos tópicos do vaso. Retorna o msg_id (-1 em caso de erro).
+static int publish_sensor(const sensor_t *sensor, const char *sufixo, const char *valor) {
+    char topico[SENSOR_TOPICO_MAX + 24];
+    sensor_table_topic(sensor, sufixo, topico, sizeof(topico));
+    return mqtt_publish(topico, valor, 0);
 }
 
 // Gerencia a conexão MQTT e processa mensagens de configuração recebidas.
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data) {
     esp_mqtt_event_handle_t event = event_data;
-    char topic_buffer[100];
-    char data_buffer[100];
 
     switch ((esp_mqtt_event_id_t)event_id) {
     case MQTT_EVENT_CONNECTED:
         ESP_LOGI(TAG, "Conectado ao broker MQTT!");
-        // Assina o tópico de configuração para poder receber comandos remotos.
-        esp_mqtt_client_subscribe(mqtt_client, MQTT_TOPIC_SET_TIPO, 0);
-        ESP_LOGI(TAG, "Assinando o tópico de configuração: %s", MQTT_TOPIC_SET_TIPO);
+        // Assina os tópicos de configuração de cada vaso para poder receber comandos remotos.
+        remote_config_subscribe(mqtt_client);
+        s_mqtt_conectado = true;
+        xEventGroupSetBits(s_wifi_event_group, MQTT_CONNECTED_BIT);
+        store_forward_on_connected(); // Começa a reenviar o que ficou guardado na flash.
         break;
     case MQTT_EVENT_DISCONNECTED:
-        ESP_LOGI(TAG, "Desconectado do broker MQTT.");
+        ESP_LOGI(TAG, "Desconectado do broker MQTT. Leituras serão guardadas na flash.");
+        s_mqtt_conectado = false;
+        xEventGroupClearBits(s_wifi_event_group, MQTT_CONNECTED_BIT);
+        store_forward_on_disconnected();
+        break;
+    case MQTT_EVENT_PUBLISHED:
+        store_forward_on_published(event->msg_id);
+#if MODO_BAIXO_CONSUMO
+        low_power_on_published(event->msg_id);
+#endif
         break;
-    // Caso: Uma mensagem foi recebida em um tópico que assinamos.
+    // Caso: Uma mensagem (ou um fragmento dela) foi recebida em um tópico que assinamos.
+    // O comando é interpretado aqui e aplicado pela tarefa de configuração.
     case MQTT_EVENT_DATA:
-        // Copia o tópico e a mensagem para buffers locais.
-        strncpy(topic_buffer, event->topic, event->topic_len);
-        topic_buffer[event->topic_len] = '\0';
-        strncpy(data_buffer, event->data, event->data_len);
-        data_buffer[event->data_len] = '\0';
-        
-        ESP_LOGI(TAG, "Mensagem recebida no tópico %s: %s", topic_buffer, data_buffer);
-
-        // Verifica se a mensagem é para o tópico de configuração.
-        if (strcmp(topic_buffer, MQTT_TOPIC_SET_TIPO) == 0) {
-            int new_threshold;
-            char response_msg[200];
-            char plant_type[50];
-
-            // Compara o conteúdo da mensagem para determinar o novo limite de alerta.
-            if (strcmp(data_buffer, "padrao") == 0) {
-                new_threshold = 35;
-                strcpy(plant_type, "Planta Padrão");
-            } else if (strcmp(data_buffer, "cacto") == 0) {
-                new_threshold = 20;
-                strcpy(plant_type, "Cacto/Suculenta");
-            } else if (strcmp(data_buffer, "samambaia") == 0) {
-                new_threshold = 50;
-                strcpy(plant_type, "Samambaia (Amante de Água)");
-            } else {
-                // Se o comando for inválido, envia um aviso e não faz nada.
-                ESP_LOGW(TAG, "Tipo de planta desconhecido: %s", data_buffer);
-                sprintf(response_msg, "⚠️ SoloScan: Comando '%s' não reconhecido. Use 'padrao', 'cacto' ou 'samambaia'.", data_buffer);
-                telegram_send_message(response_msg);
-                return;
-            }
-
-            // Apenas atualiza se o novo valor for diferente do atual.
-            if (new_threshold != g_threshold_percent_seco) {
-                g_threshold_percent_seco = new_threshold;
-                save_threshold_to_nvs(g_threshold_percent_seco); // Salva a nova configuração na memória.
-                // Envia uma mensagem de confirmação para o Telegram.
-                sprintf(response_msg, "✅ SoloScan reconfigurado!\nTipo: %s\nAlerta de rega abaixo de: %d%%", plant_type, g_threshold_percent_seco);
-                telegram_send_message(response_msg);
-            } else {
-                ESP_LOGI(TAG, "O tipo de planta já era o mesmo. Nenhuma alteração feita.");
-            }
-        }
+        remote_config_on_data(event);
         break;
     // Caso: Ocorreu um erro na conexão MQTT.
     case MQTT_EVENT_ERROR:
@@ -225,19 +193,352 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     }
 }
 
-// FUNÇÃO DE CONVERSÃO DO SENSOR
-int map_to_percentage(int value) {
-    // Garante que o valor lido esteja dentro dos limites de calibração.
-    if (value < SENSOR_MIN_MOLHADO) value = SENSOR_MIN_MOLHADO;
-    if (value > SENSOR_MAX_SECO) value = SENSOR_MAX_SECO;
-    // Aplica uma "regra de três" invertida para calcular a porcentagem.
-    return 100 - ((value - SENSOR_MIN_MOLHADO) * 100) / (SENSOR_MAX_SECO - SENSOR_MIN_MOLHADO);
+#if TELEMETRIA_BINARIA
+_Static_assert(TELEMETRIA_LOTE <= TELEMETRY_MAX_READINGS, "TELEMETRIA_LOTE maior que o quadro suporta");
+// O lote pendente fica na memória RTC para não se perder entre despertares do deep sleep.
+static RTC_DATA_ATTR telemetry_batch_t s_lote_telemetria;
+
+// Publica o lote acumulado como um único quadro binário. Retorna o msg_id do quadro, ou -1 se ele
+// não foi publicado (lote vazio ou guardado na flash).
+static int telemetry_flush(void) {
+    // Leituras feitas antes de o relógio ser acertado esperam o SNTP na flash: o reenvio corrige o horário.
+    bool esperar_relogio = false;
+    for (size_t i = 0; i < s_lote_telemetria.n; i++) {
+        if (!clock_sync_fix(&s_lote_telemetria.leituras[i]) && clock_sync_pending()) esperar_relogio = true;
+    }
+    if (!s_mqtt_conectado || esperar_relogio) {
+        // A conexão caiu enquanto o lote enchia (ou o relógio ainda não vale): as leituras vão para a flash.
+        for (size_t i = 0; i < s_lote_telemetria.n; i++) {
+            store_forward_append(&s_lote_telemetria.leituras[i]);
+        }
+        telemetry_batch_reset(&s_lote_telemetria);
+        return -1;
+    }
+    uint8_t quadro[TELEMETRY_FRAME_MAX_BYTES];
+    size_t tamanho = telemetry_encode(&s_lote_telemetria, quadro, sizeof(quadro));
+    int msg_id = -1;
+    if (tamanho > 0) {
+        msg_id = mqtt_publish(MQTT_TOPIC_TELEMETRIA, (const char *)quadro, tamanho);
+        ESP_LOGI(TAG, "Quadro de telemetria enviado: %u leituras em %u bytes.", (unsigned)s_lote_telemetria.n, (unsigned)tamanho);
+    }
+    telemetry_batch_reset(&s_lote_telemetria);
+    return msg_id;
+}
+
+// Envia o lote incompleto depois de TELEMETRIA_FLUSH_S mesmo sem leitura nova: com o relatório por
+// exceção pode não sair leitura até o heartbeat, e o lote em RAM se perderia em um reset.
+static void telemetry_flush_if_due(void) {
+    if (s_lote_telemetria.n > 0 &&
+        (uint32_t)time(NULL) - s_lote_telemetria.leituras[0].timestamp >= TELEMETRIA_FLUSH_S) {
+        telemetry_flush();
+    }
+}
+#endif
+
+// Publica as leituras de um ciclo (as que passaram pela publicação por exceção) como um único
+// relatório: no modo binário acumulando no lote; em texto, nos tópicos originais se a tabela tiver
+// um vaso só, senão em /leituras (mesmo que só um vaso tenha mudado no ciclo).
+// Sem conexão com o broker, as leituras são guardadas na flash para serem reenviadas depois.
+// mudou_estado força o envio imediato do lote para que a mudança não fique parada no buffer.
+// O número de sequência é dado aqui, só às leituras que saem: o quadro binário guarda apenas o
+// seq da primeira e as seguintes são implícitas, então não pode haver buracos entre elas.
+// Retorna o msg_id da publicação que leva as leituras deste ciclo, ou -1 se elas não saíram agora
+// (guardadas na flash ou esperando no lote binário).
+static int publish_report(telemetry_reading_t *leituras, size_t n, bool mudou_estado) {
+    static RTC_DATA_ATTR uint32_t seq = 0;
+    static bool publicou; // Falso até a primeira publicação deste boot ou despertar (fora da memória RTC).
+    for (size_t i = 0; i < n; i++) {
+        leituras[i].seq = seq++;
+    }
+    if (!s_mqtt_conectado) {
+        for (size_t i = 0; i < n; i++) {
+            store_forward_append(&leituras[i]);
+        }
+        return -1;
+    }
+    if (!publicou) {
+        // O esp_timer conta desde o boot (ou o despertar), então o valor é o tempo até a primeira publicação.
+        metrics_record(METRIC_FIRST_PUBLISH, (uint32_t)esp_timer_get_time());
+        ESP_LOGI(TAG, "Primeira publicação %u ms após o boot.", (unsigned)(esp_timer_get_time() / 1000));
+        publicou = true;
+    }
+#if TELEMETRIA_BINARIA
+    // As leituras de um ciclo nunca são divididas entre dois quadros.
+    if (s_lote_telemetria.n + n > TELEMETRY_MAX_READINGS) {
+        telemetry_flush();
+    }
+    for (size_t i = 0; i < n; i++) {
+        telemetry_batch_add(&s_lote_telemetria, &leituras[i]);
+    }
+    if (mudou_estado || s_lote_telemetria.n >= TELEMETRIA_LOTE ||
+        leituras[0].timestamp - s_lote_telemetria.leituras[0].timestamp >= TELEMETRIA_FLUSH_S) {
+        return telemetry_flush();
+    }
+    return -1;
+#else
+    char buffer[256];
+    if (sensor_table_count() == 1) {
+        const sensor_t *sensor = sensor_table_get(leituras[0].sensor);
+        sprintf(buffer, "%d", leituras[0].raw);
+        publish_sensor(sensor, MQTT_SUFIXO_LEITURA, buffer);
+        sprintf(buffer, "%d%%", leituras[0].percent);
+        return publish_sensor(sensor, MQTT_SUFIXO_PERCENT, buffer);
+    }
+    // Vários vasos: "nome=raw,pct%;nome=raw,pct%;..." em uma só publicação (vaso sem nome usa o índice).
+    size_t usado = 0;
+    for (size_t i = 0; i < n && usado < sizeof(buffer); i++) {
+        const char *nome = sensor_table_get(leituras[i].sensor)->config->nome;
+        char indice[4];
+        if (nome[0] == '\0') {
+            snprintf(indice, sizeof(indice), "%u", leituras[i].sensor);
+            nome = indice;
+        }
+        usado += snprintf(buffer + usado, sizeof(buffer) - usado, "%s%s=%d,%d%%", i > 0 ? ";" : "",
+                          nome, leituras[i].raw, leituras[i].percent);
+    }
+    return mqtt_publish(MQTT_TOPIC_LEITURAS, buffer, 0);
+#endif
+}
+
+// Monta a leitura de um vaso no formato usado pela telemetria e pelo log da flash.
+// O seq fica para publish_report.
+static telemetry_reading_t make_reading(const sensor_t *sensor, int valor_raw, int umidade_percentual, bool seco) {
+    // O relógio do sistema continua contando durante o deep sleep, ao contrário do esp_timer.
+    telemetry_reading_t leitura = {
+        .timestamp = (uint32_t)time(NULL),
+        .raw = (uint16_t)valor_raw,
+        .percent = (uint8_t)umidade_percentual,
+        .sensor = (uint8_t)sensor_table_index(sensor),
+        .seco = seco,
+        .boot = clock_sync_boot(),
+    };
+    return leitura;
+}
+
+static void set_led(const sensor_t *sensor, bool aceso) {
+    board_led_set(sensor->config->led, aceso);
 }
 
-// FUNÇÃO PRINCIPAL 
+// Compara a leitura de um vaso com o limite de alerta e só notifica na MUDANÇA de estado.
+// Retorna true se o estado mudou.
+static bool monitor_cycle(const sensor_t *sensor, const sensor_reading_t *leitura, telemetry_reading_t *saida) {
+    char buffer[256]; // Buffer para formatar as mensagens.
+    char rotulo[24];
+    size_t indice = sensor_table_index(sensor);
+    int valor_umidade_raw = leitura->filtrado;
+    int umidade_percentual = sensor_table_percent(sensor, valor_umidade_raw);
+    ESP_LOGI(TAG, "Sensor %u: %d (média %u, mediana %u) | Porcentagem: %d%% | Limite de Alerta: %d%%", (unsigned)indice, valor_umidade_raw, leitura->media, leitura->mediana, umidade_percentual, sensor->threshold);
+
+    bool estado_anterior_seco = ultimo_estado_seco[indice];
+    sensor_table_label(sensor, rotulo, sizeof(rotulo));
+
+    // Com histerese, a planta seca só volta a "úmida" acima de threshold + histerese.
+    int limite = ultimo_estado_seco[indice] ? sensor->threshold + sensor->histerese : sensor->threshold;
+    if (umidade_percentual < limite) {
+        set_led(sensor, true);
+        // Se o estado anterior NÃO era seco, significa que a planta acabou de secar.
+        if (!ultimo_estado_seco[indice]) {
+            ESP_LOGI(TAG, "Planta %u secou! Enviando alertas...", (unsigned)indice);
+            publish_sensor(sensor, MQTT_SUFIXO_STATUS, "SECO");
+            publish_sensor(sensor, MQTT_SUFIXO_ALERTA, "REGAR");
+            sprintf(buffer, "🚨 Alerta SoloScan%s: A umidade da sua planta caiu para %d%%. Hora de regar! 🌱", rotulo, umidade_percentual);
+            telegram_notify(buffer);
+            ultimo_estado_seco[indice] = true; // Atualiza o estado para "seco".
+        }
+    } else {
+        set_led(sensor, false);
+        // Se o estado anterior ERA seco, significa que a planta acabou de ser regada.
+        if (ultimo_estado_seco[indice]) {
+            ESP_LOGI(TAG, "Planta %u foi regada. Resetando alertas.", (unsigned)indice);
+            publish_sensor(sensor, MQTT_SUFIXO_STATUS, "UMIDO");
+            publish_sensor(sensor, MQTT_SUFIXO_ALERTA, "OK");
+            sprintf(buffer, "✅ SoloScan%s: Obrigado por regar! A umidade voltou para %d%%. ✨💧", rotulo, umidade_percentual);
+            telegram_notify(buffer);
+            ultimo_estado_seco[indice] = false; // Atualiza o estado para "úmido".
+        }
+    }
+
+    *saida = make_reading(sensor, valor_umidade_raw, umidade_percentual, ultimo_estado_seco[indice]);
+    return ultimo_estado_seco[indice] != estado_anterior_seco;
+}
+
+// Um ciclo do agendador: pega a última varredura de todos os canais, avalia cada vaso e
+// publica um único relatório com as leituras que devem sair. Retorna o intervalo até o próximo ciclo;
+// msg_id recebe o da publicação do relatório (-1 se nada saiu agora).
+static uint32_t scan_cycle(int *msg_id) {
+    *msg_id = -1;
+    telemetry_reading_t leituras[SENSOR_TABLE_MAX];
+    size_t n = 0;
+    bool mudou_estado = false;
+    uint32_t intervalo_ms = remote_config_interval_ms();
+#if AMOSTRAGEM_ADAPTATIVA
+    uint32_t proximo_ms = UINT32_MAX;
+#endif
+
+    for (size_t i = 0; i < sensor_table_count(); i++) {
+        sensor_reading_t leitura;
+        // Pega a leitura filtrada mais recente da amostragem contínua.
+        if (sensor_adc_get(i, &leitura) != ESP_OK) {
+            ESP_LOGW(TAG, "Nenhuma leitura do sensor %u disponível ainda.", (unsigned)i);
+            continue;
+        }
+        bool mudou = monitor_cycle(sensor_table_get(i), &leitura, &leituras[n]);
+        mudou_estado |= mudou;
+#if SERVIDOR_HISTORICO && !MODO_BAIXO_CONSUMO
+        history_server_add(&leituras[n]);
+#endif
+#if AMOSTRAGEM_ADAPTATIVA
+        // O vaso que muda mais rápido define o intervalo; só entram no relatório as leituras que andaram.
+        uint32_t vaso_ms = adaptive_update(&s_amostragem[i], &AMOSTRAGEM, intervalo_ms, leituras[n].timestamp, leituras[n].percent);
+        if (vaso_ms < proximo_ms) proximo_ms = vaso_ms;
+        if (!adaptive_should_report(&s_amostragem[i], &AMOSTRAGEM, leituras[n].timestamp, leituras[n].percent, mudou)) {
+            continue;
+        }
+#endif
+        n++;
+    }
+#if AMOSTRAGEM_ADAPTATIVA
+    if (proximo_ms != UINT32_MAX) intervalo_ms = proximo_ms;
+    ESP_LOGI(TAG, "Próxima leitura em %u ms; %u leituras para publicar.", (unsigned)intervalo_ms, (unsigned)n);
+#endif
+    ESP_LOGI(TAG, "Varredura de %u sensores em %u us.", (unsigned)sensor_table_count(), (unsigned)sensor_adc_last_scan_us());
+    if (n == 0) return intervalo_ms;
+    *msg_id = publish_report(leituras, n, mudou_estado);
+    return intervalo_ms;
+}
+
+// Espera até o próximo ciclo, acordando a cada varredura contínua do ADC (uma por segundo) para
+// enviar o lote de telemetria vencido. Na amostragem adaptativa também acorda antes se algum vaso
+// sair da banda morta, o que custa uma consulta à tabela de calibração por vaso a cada varredura.
+static void wait_next_cycle(uint32_t intervalo_ms) {
+    TickType_t inicio = xTaskGetTickCount();
+    TickType_t espera = pdMS_TO_TICKS(intervalo_ms);
+    TickType_t passado;
+    while ((passado = xTaskGetTickCount() - inicio) < espera) {
+        if (sensor_adc_wait(espera - passado) != ESP_OK) return;
+#if TELEMETRIA_BINARIA
+        telemetry_flush_if_due();
+#endif
+#if AMOSTRAGEM_ADAPTATIVA
+        for (size_t i = 0; i < sensor_table_count(); i++) {
+            sensor_reading_t leitura;
+            if (sensor_adc_get(i, &leitura) == ESP_OK &&
+                adaptive_moved(&s_amostragem[i], &AMOSTRAGEM, (uint8_t)sensor_table_percent(sensor_table_get(i), leitura.filtrado))) {
+                ESP_LOGI(TAG, "Umidade do sensor %u mudou; lendo antes do intervalo.", (unsigned)i);
+                return;
+            }
+        }
+#endif
+    }
+}
+
+// Publica o relatório de métricas a cada METRICAS_INTERVALO_S (pelo relógio do sistema, que segue contando no deep sleep).
+static void publish_metrics(void) {
+    static RTC_DATA_ATTR uint32_t ultima_s;
+    uint32_t agora_s = (uint32_t)time(NULL);
+    if (!s_mqtt_conectado || agora_s - ultima_s < METRICAS_INTERVALO_S) return;
+    char buffer[640];
+    size_t n = metrics_format(buffer, sizeof(buffer));
+    // Contadores do Telegram: fila atual/máxima e mensagens enviadas/agrupadas/falhas/descartadas.
+    telegram_stats_t tg;
+    telegram_notifier_get_stats(&tg);
+    snprintf(buffer + n, sizeof(buffer) - n, ";tg_fila=%u/%u;tg_msg=%u/%u/%u/%u", (unsigned)tg.fila_atual,
+             (unsigned)tg.fila_max, (unsigned)tg.enviadas, (unsigned)tg.agrupadas, (unsigned)tg.falhas,
+             (unsigned)tg.descartadas);
+    ESP_LOGI(TAG, "Métricas: %s", buffer);
+    mqtt_publish(MQTT_TOPIC_METRICAS, buffer, 0);
+    ultima_s = agora_s;
+}
+
+#if MODO_BAIXO_CONSUMO
+// Espera o broker confirmar tudo que foi publicado (e o Telegram e o backlog esvaziarem), até o prazo.
+static void wait_for_publishes(int64_t prazo_us) {
+    while (esp_timer_get_time() < prazo_us) {
+        if (esp_mqtt_client_get_outbox_size(mqtt_client) == 0 && telegram_notifier_idle() && store_forward_pending() == 0 &&
+            remote_config_idle()) {
+            return;
+        }
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+    ESP_LOGW(TAG, "Prazo acordado esgotado antes de todas as confirmações.");
+}
+
+// Um despertar do modo de baixo consumo: lê, publica, relata a energia e volta a dormir.
+// ler_sensor é falso no primeiro boot, quando a leitura inicial já foi publicada.
+static void low_power_cycle(bool ler_sensor) {
+    int64_t prazo_us = esp_timer_get_time() + (int64_t)BAIXO_CONSUMO_MAX_ACORDADO_MS * 1000;
+    uint32_t intervalo_ms = remote_config_interval_ms();
+
+    // A conexão MQTT sobe em paralelo com a primeira varredura do ADC.
+    xEventGroupWaitBits(s_wifi_event_group, MQTT_CONNECTED_BIT, pdFALSE, pdTRUE, pdMS_TO_TICKS(BAIXO_CONSUMO_MAX_ACORDADO_MS));
+    if (ler_sensor && sensor_adc_wait(pdMS_TO_TICKS(SENSOR_ADC_PERIOD_MS * 2)) == ESP_OK) {
+        int msg_id;
+        intervalo_ms = scan_cycle(&msg_id);
+        low_power_expect_publish(msg_id);
+    }
+#if TELEMETRIA_BINARIA
+    telemetry_flush_if_due();
+#endif
+    publish_metrics();
+    // O tempo de publicação é marcado pelo PUBACK da leitura (low_power_on_published), não aqui.
+    wait_for_publishes(prazo_us);
+
+    low_power_report_t rel;
+    low_power_get_report(&rel);
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), "despertar=%u;acordado_ms=%u;publicacao_ms=%u;energia_est_mj=%u;sempre_ligado_est_mj=%u;wifi_rapido=%d",
+             (unsigned)rel.despertares, (unsigned)rel.acordado_ms, (unsigned)rel.publicacao_ms,
+             (unsigned)rel.energia_est_mj, (unsigned)rel.energia_sempre_ligado_est_mj, rel.wifi_rapido);
+    ESP_LOGI(TAG, "Relatório de energia: %s", buffer);
+    if (s_mqtt_conectado) {
+        mqtt_publish(MQTT_TOPIC_ENERGIA, buffer, 0);
+        wait_for_publishes(prazo_us);
+    }
+
+    // Mantém os LEDs no estado atual durante o sono.
+    for (size_t i = 0; i < sensor_table_count(); i++) {
+        board_led_hold(sensor_table_get(i)->config->led);
+    }
+    esp_mqtt_client_stop(mqtt_client);
+    low_power_sleep(intervalo_ms);
+}
+#endif
+
+// Acompanha cada varredura do ADC até as leituras filtradas de todos os vasos pararem de andar
+// (ou ESTABILIZACAO_MAX_MS passar). Substitui a pausa fixa de 3 minutos do boot.
+static void wait_for_stable_readings(void) {
+    sensor_settle_t detectores[SENSOR_TABLE_MAX];
+    for (size_t i = 0; i < sensor_table_count(); i++) {
+        sensor_settle_init(&detectores[i], ESTABILIZACAO_TOLERANCIA);
+    }
+    ESP_LOGI(TAG, "Aguardando a estabilização do sensor...");
+    while (esp_timer_get_time() < (int64_t)ESTABILIZACAO_MAX_MS * 1000) {
+        if (sensor_adc_wait(pdMS_TO_TICKS(SENSOR_ADC_PERIOD_MS * 2)) != ESP_OK) continue;
+        size_t estaveis = 0;
+        for (size_t i = 0; i < sensor_table_count(); i++) {
+            sensor_reading_t leitura;
+            if (sensor_adc_get(i, &leitura) == ESP_OK && sensor_settle_update(&detectores[i], leitura.filtrado)) {
+                estaveis++;
+            }
+        }
+        if (estaveis == sensor_table_count()) {
+            ESP_LOGI(TAG, "Sensores estáveis %u ms após o boot.", (unsigned)(esp_timer_get_time() / 1000));
+            return;
+        }
+    }
+    ESP_LOGW(TAG, "Sensores não estabilizaram em %u s; seguindo com a leitura atual.", ESTABILIZACAO_MAX_MS / 1000);
+}
+
+// FUNÇÃO PRINCIPAL
 void app_main(void) {
     ESP_LOGI(TAG, "[APP] Startup..");
-    
+    // Tarefas cujo mínimo de stack livre aparece em /metrics (as que não existirem são ignoradas).
+    static const char *TAREFAS[] = { "main", "sensor_adc", "store_forward", "telegram", "remote_config",
+                                     "mqtt_task", "tiT", "sys_evt", "wifi", "httpd" };
+    for (size_t i = 0; i < sizeof(TAREFAS) / sizeof(TAREFAS[0]); i++) {
+        metrics_watch_task(TAREFAS[i]);
+    }
+
     // Inicializa a memória flash não-volátil (NVS).
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
@@ -245,93 +546,113 @@ void app_main(void) {
       ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    ESP_ERROR_CHECK(clock_sync_init());
 
-    load_threshold_from_nvs(); // Carrega a última configuração salva.
-    wifi_init_sta(); // Inicia o Wi-Fi e espera conectar.
+    // O boot não espera pela rede: o ADC começa a aquecer primeiro, o Wi-Fi se associa e o MQTT
+    // conecta em segundo plano, e a primeira leitura sai quando o sensor estabiliza.
+    ESP_ERROR_CHECK(sensor_table_init(SENSORES, N_SENSORES, MQTT_BASE_TOPIC));
 
-    // Configura os pinos do LED e do sensor.
-    gpio_reset_pin(LED_PIN);
-    gpio_set_direction(LED_PIN, GPIO_MODE_OUTPUT);
-    adc1_config_width(ADC_WIDTH_BIT_12);
-    adc1_config_channel_atten(SENSOR_PIN, ADC_ATTEN_DB_11);
-    
-    // Configura e inicia o cliente MQTT.
+    // Configura os LEDs e os canais do ADC de todos os vasos.
+    board_channel_t canais[SENSOR_TABLE_MAX];
+    for (size_t i = 0; i < N_SENSORES; i++) {
+        canais[i] = SENSORES[i].canal;
+        board_led_init(SENSORES[i].led);
+    }
+    // Inicia a amostragem contínua com DMA; as leituras ficam filtradas em segundo plano.
+    ESP_ERROR_CHECK(sensor_adc_init(canais, N_SENSORES));
+
+    sensor_table_load(); // Carrega a última configuração salva de cada vaso.
+    ESP_ERROR_CHECK(remote_config_init(INTERVALO_LEITURA_MS));
+
+    // Configura o cliente MQTT; ele é iniciado pelo handler do Wi-Fi quando houver IP.
     esp_mqtt_client_config_t mqtt_cfg = { .broker.address.uri = MQTT_BROKER_URL, };
     mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
     esp_mqtt_client_register_event(mqtt_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
-    esp_mqtt_client_start(mqtt_client);
+    // O backlog da flash é sempre reenviado em quadros binários, que preservam horário e sequência.
+    ESP_ERROR_CHECK(store_forward_init(mqtt_client, MQTT_TOPIC_TELEMETRIA));
+
+    s_wifi_event_group = xEventGroupCreate();
+    board_network_start(WIFI_SSID, WIFI_PASS, on_network_connected); // Inicia a rede sem esperar conectar.
+#if SERVIDOR_HISTORICO && !MODO_BAIXO_CONSUMO
+    ESP_ERROR_CHECK(history_server_init(N_SENSORES));
+    ESP_ERROR_CHECK(history_server_start(HISTORY_SERVER_PORTA));
+#endif
+
+    // As notificações do Telegram são enviadas por uma tarefa própria, sem travar quem chama.
+    telegram_notifier_config_t telegram_cfg = {
+        .token = TELEGRAM_TOKEN,
+        .chat_id = TELEGRAM_CHAT_ID,
+        .api_url = TELEGRAM_API_URL,
+        .cert_pem = TELEGRAM_CERT_PEM,
+    };
+    ESP_ERROR_CHECK(telegram_notifier_init(&telegram_cfg));
+
+#if MODO_BAIXO_CONSUMO
+    // Ao acordar do deep sleep o sensor já estava estabilizado e o estado anterior está no RTC.
+    if (low_power_woke_from_sleep()) {
+        low_power_cycle(true);
+    }
+#endif
 
-    ESP_LOGI(TAG, "Aguardando 3 minutos para estabilização do sensor...");
-    vTaskDelay(pdMS_TO_TICKS(180000)); // Pausa de 3 minutos.
+    wait_for_stable_readings();
+    // A primeira leitura vai direto para o broker se ele conectar logo; senão, para a flash.
+    if (!(xEventGroupWaitBits(s_wifi_event_group, MQTT_CONNECTED_BIT, pdFALSE, pdTRUE, pdMS_TO_TICKS(BOOT_MQTT_MAX_MS)) & MQTT_CONNECTED_BIT)) {
+        ESP_LOGW(TAG, "Broker MQTT ainda indisponível; a leitura inicial será guardada na flash.");
+    }
 
-    bool ultimo_estado_seco; // Variável para rastrear o estado anterior.
     char buffer[256]; // Buffer para formatar as mensagens.
+    telemetry_reading_t leituras[SENSOR_TABLE_MAX];
+    size_t n = 0;
 
-    // Faz a primeira leitura de umidade.
-    int valor_inicial_raw = adc1_get_raw(SENSOR_PIN);
-    int umidade_percentual = map_to_percentage(valor_inicial_raw);
-    ESP_LOGI(TAG, "Leitura inicial: %d | Porcentagem: %d%% | Limite de Alerta: %d%%", valor_inicial_raw, umidade_percentual, g_threshold_percent_seco);
-    
-    // Publica os dados iniciais nos tópicos MQTT.
-    sprintf(buffer, "%d", valor_inicial_raw);
-    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_LEITURA, buffer, 0, 1, 0);
-    sprintf(buffer, "%d%%", umidade_percentual);
-    esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_PERCENT, buffer, 0, 1, 0);
-
-    // Determina o estado inicial e publica o status/alerta correspondente.
-    if (umidade_percentual < g_threshold_percent_seco) {
-        ultimo_estado_seco = true;
-        gpio_set_level(LED_PIN, 1); // Acende o LED.
-        esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_STATUS, "SECO", 0, 1, 0);
-        esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_ALERTA, "REGAR", 0, 1, 0);
-        sprintf(buffer, "SoloScan Iniciado! 🚨\nSua planta já está seca, com apenas %d%% de umidade.", umidade_percentual);
-    } else {
-        ultimo_estado_seco = false;
-        gpio_set_level(LED_PIN, 0); // Apaga o LED.
-        esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_STATUS, "UMIDO", 0, 1, 0);
-        esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_ALERTA, "OK", 0, 1, 0);
-        sprintf(buffer, "SoloScan Iniciado! 🌱\nSua planta está com ótimos %d%% de umidade. Não precisa regar agora. ✅", umidade_percentual);
+    // Faz a primeira leitura de cada vaso (a amostragem já rodou durante a estabilização).
+    for (size_t i = 0; i < sensor_table_count(); i++) {
+        sensor_t *sensor = sensor_table_get(i);
+        sensor_reading_t leitura;
+        char rotulo[24];
+        ESP_ERROR_CHECK(sensor_adc_get(i, &leitura));
+        int valor_inicial_raw = leitura.filtrado;
+        int umidade_percentual = sensor_table_percent(sensor, valor_inicial_raw);
+        ESP_LOGI(TAG, "Leitura inicial do sensor %u: %d | Porcentagem: %d%% | Limite de Alerta: %d%%", (unsigned)i, valor_inicial_raw, umidade_percentual, sensor->threshold);
+        sensor_table_label(sensor, rotulo, sizeof(rotulo));
+
+        // Determina o estado inicial e publica o status/alerta correspondente.
+        if (umidade_percentual < sensor->threshold) {
+            ultimo_estado_seco[i] = true;
+            set_led(sensor, true); // Acende o LED.
+            publish_sensor(sensor, MQTT_SUFIXO_STATUS, "SECO");
+            publish_sensor(sensor, MQTT_SUFIXO_ALERTA, "REGAR");
+            sprintf(buffer, "SoloScan%s Iniciado! 🚨\nSua planta já está seca, com apenas %d%% de umidade.", rotulo, umidade_percentual);
+        } else {
+            ultimo_estado_seco[i] = false;
+            set_led(sensor, false); // Apaga o LED.
+            publish_sensor(sensor, MQTT_SUFIXO_STATUS, "UMIDO");
+            publish_sensor(sensor, MQTT_SUFIXO_ALERTA, "OK");
+            sprintf(buffer, "SoloScan%s Iniciado! 🌱\nSua planta está com ótimos %d%% de umidade. Não precisa regar agora. ✅", rotulo, umidade_percentual);
+        }
+        leituras[n] = make_reading(sensor, valor_inicial_raw, umidade_percentual, ultimo_estado_seco[i]);
+#if SERVIDOR_HISTORICO && !MODO_BAIXO_CONSUMO
+        history_server_add(&leituras[n]);
+#endif
+#if AMOSTRAGEM_ADAPTATIVA
+        adaptive_update(&s_amostragem[i], &AMOSTRAGEM, remote_config_interval_ms(), leituras[n].timestamp, leituras[n].percent);
+        adaptive_should_report(&s_amostragem[i], &AMOSTRAGEM, leituras[n].timestamp, leituras[n].percent, true);
+#endif
+        n++;
+        telegram_notify(buffer); // Envia a mensagem de status inicial para o Telegram.
     }
-    telegram_send_message(buffer); // Envia a mensagem de status inicial para o Telegram.
-    
+    // Publica os dados iniciais (a primeira leitura sempre é enviada na hora).
+    int msg_id = publish_report(leituras, n, true);
+
+#if MODO_BAIXO_CONSUMO
+    low_power_expect_publish(msg_id);
+    low_power_cycle(false);
+#endif
+
     // Inicia o ciclo de monitoramento.
+    uint32_t intervalo_ms = remote_config_interval_ms();
     while (1) {
-        vTaskDelay(pdMS_TO_TICKS(30000)); // Pausa o programa por 30 segundos. (só para testes)
-
-        // Faz uma nova leitura de umidade.
-        int valor_umidade_raw = adc1_get_raw(SENSOR_PIN);
-        umidade_percentual = map_to_percentage(valor_umidade_raw);
-        ESP_LOGI(TAG, "Leitura: %d | Porcentagem: %d%% | Limite de Alerta: %d%%", valor_umidade_raw, umidade_percentual, g_threshold_percent_seco);
-
-        // Publica os dados de leitura no MQTT a cada ciclo.
-        sprintf(buffer, "%d", valor_umidade_raw);
-        esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_LEITURA, buffer, 0, 1, 0);
-        sprintf(buffer, "%d%%", umidade_percentual);
-        esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_PERCENT, buffer, 0, 1, 0);
-
-        // Só notifica na MUDANÇA de estado.
-        if (umidade_percentual < g_threshold_percent_seco) {
-            gpio_set_level(LED_PIN, 1);
-            // Se o estado anterior NÃO era seco, significa que a planta acabou de secar.
-            if (!ultimo_estado_seco) {
-                ESP_LOGI(TAG, "Planta secou! Enviando alertas...");
-                esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_STATUS, "SECO", 0, 1, 0);
-                esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_ALERTA, "REGAR", 0, 1, 0);
-                sprintf(buffer, "🚨 Alerta SoloScan: A umidade da sua planta caiu para %d%%. Hora de regar! 🌱", umidade_percentual);
-                telegram_send_message(buffer);
-                ultimo_estado_seco = true; // Atualiza o estado para "seco".
-            }
-        } else {
-            gpio_set_level(LED_PIN, 0);
-            // Se o estado anterior ERA seco, significa que a planta acabou de ser regada.
-            if (ultimo_estado_seco) {
-                ESP_LOGI(TAG, "Planta foi regada. Resetando alertas.");
-                esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_STATUS, "UMIDO", 0, 1, 0);
-                esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_ALERTA, "OK", 0, 1, 0);
-                sprintf(buffer, "✅ SoloScan: Obrigado por regar! A umidade voltou para %d%%. ✨💧", umidade_percentual);
-                telegram_send_message(buffer);
-                ultimo_estado_seco = false; // Atualiza o estado para "úmido".
-            }
-        }
+        wait_next_cycle(intervalo_ms);
+        intervalo_ms = scan_cycle(&msg_id);
+        publish_metrics();
     }
 }
@@ -0,0 +1,94 @@
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+
+static const char *NOMES[METRIC_COUNT] = {
+    [METRIC_ADC_SCAN] = "adc",
+    [METRIC_MQTT_PUBLISH] = "pub",
+    [METRIC_TELEGRAM_SEND] = "tg",
+    [METRIC_TELEGRAM_QUEUE] = "tgq",
+    [METRIC_NVS_COMMIT] = "nvs",
+    [METRIC_WIFI_CONNECT] = "wifi",
+    [METRIC_HTTP_REQUEST] = "http",
+    [METRIC_FIRST_PUBLISH] = "boot",
+};
+
+static metrics_histogram_t s_hist[METRIC_COUNT];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static const char *s_tarefas[METRICS_MAX_TAREFAS];
+static size_t s_n_tarefas;
+
+static inline size_t faixa(uint32_t us) {
+    if (us == 0) return 0;
+    size_t f = 31 - (size_t)__builtin_clz(us);
+    return f < METRICS_FAIXAS ? f : METRICS_FAIXAS - 1;
+}
+
+void metrics_record(metric_id_t id, uint32_t duracao_us) {
+    size_t f = faixa(duracao_us);
+    metrics_histogram_t *h = &s_hist[id];
+    portENTER_CRITICAL(&s_lock);
+    h->n++;
+    h->soma_us += duracao_us;
+    if (duracao_us > h->max_us) h->max_us = duracao_us;
+    h->faixas[f]++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void metrics_watch_task(const char *nome) {
+    if (s_n_tarefas < METRICS_MAX_TAREFAS) {
+        s_tarefas[s_n_tarefas++] = nome;
+    }
+}
+
+void metrics_get(metric_id_t id, metrics_histogram_t *saida) {
+    portENTER_CRITICAL(&s_lock);
+    *saida = s_hist[id];
+    portEXIT_CRITICAL(&s_lock);
+}
+
+uint32_t metrics_percentile(const metrics_histogram_t *h, uint32_t percentil) {
+    if (h->n == 0) return 0;
+    uint64_t alvo = ((uint64_t)h->n * percentil + 99) / 100;
+    uint64_t acumulado = 0;
+    for (size_t f = 0; f < METRICS_FAIXAS; f++) {
+        acumulado += h->faixas[f];
+        if (acumulado >= alvo) {
+            // O limite superior da faixa nunca passa do máximo observado; a última faixa não tem limite.
+            if (f == METRICS_FAIXAS - 1) return h->max_us;
+            uint32_t limite = (1u << (f + 1)) - 1;
+            return limite < h->max_us ? limite : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+size_t metrics_format(char *saida, size_t len) {
+    size_t usado = 0;
+#define ACRESCENTAR(...)                                                     \
+    do {                                                                     \
+        if (usado < len) usado += snprintf(saida + usado, len - usado, __VA_ARGS__); \
+    } while (0)
+
+    ACRESCENTAR("up=%u;heap=%u;heap_min=%u", (unsigned)(esp_timer_get_time() / 1000000),
+                (unsigned)esp_get_free_heap_size(), (unsigned)esp_get_minimum_free_heap_size());
+    for (size_t id = 0; id < METRIC_COUNT; id++) {
+        metrics_histogram_t h;
+        metrics_get((metric_id_t)id, &h);
+        ACRESCENTAR(";%s=%u/%u/%u/%u", NOMES[id], (unsigned)h.n, (unsigned)metrics_percentile(&h, 50),
+                    (unsigned)metrics_percentile(&h, 90), (unsigned)h.max_us);
+    }
+    ACRESCENTAR(";stack=");
+    const char *separador = "";
+    for (size_t i = 0; i < s_n_tarefas; i++) {
+        TaskHandle_t tarefa = xTaskGetHandle(s_tarefas[i]);
+        if (tarefa == NULL) continue;
+        ACRESCENTAR("%s%s:%u", separador, s_tarefas[i], (unsigned)uxTaskGetStackHighWaterMark(tarefa));
+        separador = ",";
+    }
+#undef ACRESCENTAR
+    return usado < len ? usado : len - 1;
+}
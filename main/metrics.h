@@ -0,0 +1,59 @@
+#pragma once
+
+// Instrumentação leve dos caminhos quentes: histogramas de latência com faixas fixas,
+// memória livre e uso de stack das tarefas.
+// Registrar uma medida custa uma leitura do esp_timer, uma contagem de zeros à esquerda e
+// alguns incrementos dentro de uma seção crítica curta, então pode ficar ligado em produção.
+//
+// Faixas do histograma: a faixa i conta durações em [2^i, 2^(i+1)) µs (a faixa 0 inclui o 0);
+// a última faixa acumula tudo acima de 2^(METRICS_FAIXAS-1) µs (~8 s).
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_timer.h"
+
+#define METRICS_FAIXAS      24
+#define METRICS_MAX_TAREFAS 10
+
+typedef enum {
+    METRIC_ADC_SCAN,        // Varredura completa dos canais do ADC.
+    METRIC_MQTT_PUBLISH,    // Cada chamada de esp_mqtt_client_publish.
+    METRIC_TELEGRAM_SEND,   // Cada requisição HTTP para o Telegram.
+    METRIC_TELEGRAM_QUEUE,  // Da entrada de um alerta na fila do Telegram até a confirmação do envio.
+    METRIC_NVS_COMMIT,      // Abertura, gravação e commit da NVS.
+    METRIC_WIFI_CONNECT,    // Da queda (ou do início) até obter IP.
+    METRIC_HTTP_REQUEST,    // Requisição ao servidor do histórico, do início ao último pedaço.
+    METRIC_FIRST_PUBLISH,   // Do boot (ou despertar) até a primeira leitura estável publicada.
+    METRIC_COUNT,
+} metric_id_t;
+
+typedef struct {
+    uint32_t n;
+    uint32_t max_us;
+    uint64_t soma_us;
+    uint32_t faixas[METRICS_FAIXAS];
+} metrics_histogram_t;
+
+static inline int64_t metrics_start(void) {
+    return esp_timer_get_time();
+}
+
+void metrics_record(metric_id_t id, uint32_t duracao_us);
+
+static inline void metrics_record_since(metric_id_t id, int64_t inicio_us) {
+    metrics_record(id, (uint32_t)(esp_timer_get_time() - inicio_us));
+}
+
+// Acrescenta uma tarefa (pelo nome) à lista cujo mínimo de stack livre aparece no relatório.
+void metrics_watch_task(const char *nome);
+
+// Copia o histograma de uma métrica.
+void metrics_get(metric_id_t id, metrics_histogram_t *saida);
+
+// Percentil aproximado (limite superior da faixa), em µs. 0 se não há medidas.
+uint32_t metrics_percentile(const metrics_histogram_t *h, uint32_t percentil);
+
+// Monta o relatório compacto publicado em /metrics. Retorna o tamanho escrito.
+//   up=<s>;heap=<bytes>;heap_min=<bytes>;adc=n/p50/p90/max;pub=...;tg=...;tgq=...;nvs=...;wifi=...;http=...;boot=...;stack=tarefa:livre,...
+// Os tempos estão em µs e o stack em bytes livres no pior momento.
+size_t metrics_format(char *saida, size_t len);
@@ -0,0 +1,255 @@
+#include "reading_log.h"
+#include <string.h>
+
+#define READING_LOG_MAGIC        0x32515353 // "SSQ2"
+#define READING_LOG_FLAG_SECO    0x01
+#define READING_LOG_SENSOR_SHIFT 1
+#define READING_LOG_SENSOR_MASK  0x7
+#define READING_LOG_CONSUMIDO    0x00
+
+typedef enum {
+    REGISTRO_VAZIO,
+    REGISTRO_VALIDO,
+    REGISTRO_CORROMPIDO,
+} registro_estado_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t apagamentos;
+    uint32_t reservado;
+} setor_cabecalho_t;
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, v & 0xFFFF);
+    put_u16(p + 2, v >> 16);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+// CRC-16/CCITT-FALSE.
+static uint16_t crc16(const uint8_t *p, size_t len) {
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+        crc ^= (uint16_t)(*p++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t setor_offset(uint16_t setor) {
+    return (uint32_t)setor * READING_LOG_SECTOR_SIZE;
+}
+
+static uint32_t registro_offset(reading_log_pos_t pos) {
+    return setor_offset(pos.setor) + READING_LOG_HEADER_SIZE + (uint32_t)pos.slot * READING_LOG_RECORD_SIZE;
+}
+
+static bool pos_igual(reading_log_pos_t a, reading_log_pos_t b) {
+    return a.setor == b.setor && a.slot == b.slot;
+}
+
+static bool ler_cabecalho(reading_log_t *log, uint16_t setor, setor_cabecalho_t *cab) {
+    uint8_t bruto[READING_LOG_HEADER_SIZE];
+    if (!log->flash.read(log->flash.ctx, setor_offset(setor), bruto, sizeof(bruto))) return false;
+    cab->magic = get_u32(&bruto[0]);
+    cab->seq = get_u32(&bruto[4]);
+    cab->apagamentos = get_u32(&bruto[8]);
+    cab->reservado = get_u32(&bruto[12]);
+    return cab->magic == READING_LOG_MAGIC;
+}
+
+// Apaga o setor e grava um cabeçalho novo, levando adiante a contagem de apagamentos.
+static bool preparar_setor(reading_log_t *log, uint16_t setor, uint32_t seq) {
+    setor_cabecalho_t antigo;
+    uint32_t apagamentos = ler_cabecalho(log, setor, &antigo) ? antigo.apagamentos : 0;
+    if (!log->flash.erase_sector(log->flash.ctx, setor_offset(setor))) return false;
+
+    uint8_t bruto[READING_LOG_HEADER_SIZE];
+    put_u32(&bruto[0], READING_LOG_MAGIC);
+    put_u32(&bruto[4], seq);
+    put_u32(&bruto[8], apagamentos + 1);
+    put_u32(&bruto[12], 0xFFFFFFFF);
+    return log->flash.write(log->flash.ctx, setor_offset(setor), bruto, sizeof(bruto));
+}
+
+static registro_estado_t ler_registro(reading_log_t *log, reading_log_pos_t pos, telemetry_reading_t *leitura, bool *consumido) {
+    uint8_t bruto[READING_LOG_RECORD_SIZE];
+    if (!log->flash.read(log->flash.ctx, registro_offset(pos), bruto, sizeof(bruto))) return REGISTRO_CORROMPIDO;
+
+    bool vazio = true;
+    for (size_t i = 0; i < sizeof(bruto); i++) {
+        if (bruto[i] != 0xFF) {
+            vazio = false;
+            break;
+        }
+    }
+    if (vazio) return REGISTRO_VAZIO;
+    if (crc16(bruto, 13) != get_u16(&bruto[13])) return REGISTRO_CORROMPIDO;
+
+    if (leitura) {
+        leitura->timestamp = get_u32(&bruto[0]);
+        leitura->seq = get_u32(&bruto[4]);
+        leitura->raw = get_u16(&bruto[8]);
+        leitura->percent = bruto[10];
+        leitura->seco = (bruto[11] & READING_LOG_FLAG_SECO) != 0;
+        leitura->sensor = (bruto[11] >> READING_LOG_SENSOR_SHIFT) & READING_LOG_SENSOR_MASK;
+        leitura->boot = bruto[12];
+    }
+    if (consumido) *consumido = bruto[15] == READING_LOG_CONSUMIDO;
+    return REGISTRO_VALIDO;
+}
+
+// Avança para o próximo slot em ordem de log, pulando setores sem cabeçalho válido.
+// Retorna false quando chega na posição de escrita.
+static bool avancar(reading_log_t *log, reading_log_pos_t *pos) {
+    if (pos_igual(*pos, log->escrita)) return false;
+    pos->slot++;
+    if (pos->slot >= READING_LOG_SLOTS && pos->setor != log->escrita.setor) {
+        setor_cabecalho_t cab;
+        do {
+            pos->setor = (pos->setor + 1) % log->n_setores;
+            pos->slot = 0;
+        } while (pos->setor != log->escrita.setor && !ler_cabecalho(log, pos->setor, &cab));
+    }
+    return !pos_igual(*pos, log->escrita);
+}
+
+bool reading_log_open(reading_log_t *log, const reading_log_flash_t *flash) {
+    memset(log, 0, sizeof(*log));
+    log->flash = *flash;
+    log->n_setores = (uint16_t)(flash->size / READING_LOG_SECTOR_SIZE);
+    if (log->n_setores < 2) return false;
+
+    // O setor de escrita é o de maior seq; o mais antigo é o primeiro setor válido depois dele.
+    bool achou = false;
+    setor_cabecalho_t cab;
+    for (uint16_t s = 0; s < log->n_setores; s++) {
+        if (ler_cabecalho(log, s, &cab) && (!achou || (int32_t)(cab.seq - log->seq_setor) > 0)) {
+            log->seq_setor = cab.seq;
+            log->escrita.setor = s;
+            achou = true;
+        }
+    }
+    if (!achou) {
+        log->seq_setor = 1;
+        return preparar_setor(log, 0, log->seq_setor);
+    }
+
+    telemetry_reading_t lixo;
+    log->escrita.slot = 0;
+    while (log->escrita.slot < READING_LOG_SLOTS &&
+           ler_registro(log, log->escrita, &lixo, NULL) != REGISTRO_VAZIO) {
+        log->escrita.slot++;
+    }
+
+    reading_log_pos_t pos = { .setor = log->escrita.setor, .slot = 0 };
+    for (uint16_t i = 1; i < log->n_setores; i++) {
+        uint16_t s = (log->escrita.setor + i) % log->n_setores;
+        if (ler_cabecalho(log, s, &cab)) {
+            pos.setor = s;
+            break;
+        }
+    }
+
+    // Tudo até o último registro marcado como consumido já foi reenviado.
+    log->leitura = pos;
+    do {
+        bool consumido = false;
+        if (ler_registro(log, pos, NULL, &consumido) == REGISTRO_VALIDO) {
+            log->pendentes++;
+            if (consumido) {
+                log->leitura = pos;
+                avancar(log, &log->leitura);
+                log->pendentes = 0;
+            }
+        }
+    } while (avancar(log, &pos));
+    return true;
+}
+
+bool reading_log_append(reading_log_t *log, const telemetry_reading_t *leitura) {
+    if (log->escrita.slot >= READING_LOG_SLOTS) {
+        uint16_t proximo = (log->escrita.setor + 1) % log->n_setores;
+        bool vazio = log->pendentes == 0;
+
+        // Log cheio: os pendentes do setor mais antigo são perdidos.
+        if (!vazio && log->leitura.setor == proximo) {
+            reading_log_pos_t pos = log->leitura;
+            uint32_t perdidos = 0;
+            do {
+                if (ler_registro(log, pos, NULL, NULL) == REGISTRO_VALIDO) perdidos++;
+            } while (avancar(log, &pos) && pos.setor == proximo);
+            log->pendentes -= perdidos;
+            log->descartados += perdidos;
+            log->leitura = pos;
+        }
+        if (!preparar_setor(log, proximo, log->seq_setor + 1)) return false;
+        log->seq_setor++;
+        log->escrita.setor = proximo;
+        log->escrita.slot = 0;
+        if (vazio || log->pendentes == 0) log->leitura = log->escrita;
+    }
+
+    uint8_t bruto[READING_LOG_RECORD_SIZE];
+    put_u32(&bruto[0], leitura->timestamp);
+    put_u32(&bruto[4], leitura->seq);
+    put_u16(&bruto[8], leitura->raw);
+    bruto[10] = leitura->percent;
+    bruto[11] = (leitura->seco ? READING_LOG_FLAG_SECO : 0) |
+                ((leitura->sensor & READING_LOG_SENSOR_MASK) << READING_LOG_SENSOR_SHIFT);
+    bruto[12] = leitura->boot;
+    put_u16(&bruto[13], crc16(bruto, 13));
+    bruto[15] = 0xFF;
+    if (!log->flash.write(log->flash.ctx, registro_offset(log->escrita), bruto, sizeof(bruto))) return false;
+
+    log->escrita.slot++;
+    log->pendentes++;
+    return true;
+}
+
+size_t reading_log_peek(reading_log_t *log, telemetry_reading_t *saida, size_t max) {
+    size_t n = 0;
+    reading_log_pos_t pos = log->leitura;
+    if (log->pendentes == 0) return 0;
+    do {
+        if (ler_registro(log, pos, &saida[n], NULL) == REGISTRO_VALIDO) n++;
+    } while (n < max && avancar(log, &pos));
+    return n;
+}
+
+bool reading_log_consume(reading_log_t *log, size_t n) {
+    if (n == 0) return true;
+    if (n > log->pendentes) n = log->pendentes;
+
+    reading_log_pos_t pos = log->leitura;
+    reading_log_pos_t ultimo = pos;
+    size_t vistos = 0;
+    do {
+        if (ler_registro(log, pos, NULL, NULL) == REGISTRO_VALIDO) {
+            ultimo = pos;
+            vistos++;
+        }
+    } while (vistos < n && avancar(log, &pos));
+
+    const uint8_t marca = READING_LOG_CONSUMIDO;
+    if (!log->flash.write(log->flash.ctx, registro_offset(ultimo) + 15, &marca, 1)) return false;
+
+    log->leitura = ultimo;
+    avancar(log, &log->leitura);
+    log->pendentes -= vistos;
+    return true;
+}
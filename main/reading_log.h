@@ -0,0 +1,63 @@
+#pragma once
+
+// Log circular de leituras em flash, usado para guardar o que foi lido enquanto o broker estava fora.
+// Este módulo não depende do ESP-IDF: o acesso à flash vem por ponteiros de função, então o
+// mesmo formato roda no dispositivo (esp_partition) e no computador (um vetor em RAM).
+//
+// Layout: a partição é dividida em setores de 4 KB usados em ordem circular.
+//   setor:    cabeçalho de 16 bytes (magic, seq do setor, contagem de apagamentos) + 255 registros
+//   registro: timestamp (u32) | seq (u32) | raw (u16) | porcentagem (u8)
+//             | flags (u8: bit 0 seco, bits 1-3 índice do sensor) | boot (u8) | crc16 (u16)
+//             | marca de consumido (u8)
+// O boot permite acertar depois, pelo SNTP, horários gravados antes de o relógio ser sincronizado.
+// Um registro com CRC inválido (escrita interrompida) é ignorado. Depois de reenviar um lote, apenas
+// o último registro recebe a marca de consumido (gravando 0x00 sobre 0xFF, sem apagar o setor).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "telemetry.h"
+
+#define READING_LOG_SECTOR_SIZE   4096
+#define READING_LOG_HEADER_SIZE   16
+#define READING_LOG_RECORD_SIZE   16
+#define READING_LOG_SLOTS         ((READING_LOG_SECTOR_SIZE - READING_LOG_HEADER_SIZE) / READING_LOG_RECORD_SIZE)
+
+typedef struct {
+    bool (*read)(void *ctx, uint32_t offset, void *buf, size_t len);
+    bool (*write)(void *ctx, uint32_t offset, const void *buf, size_t len);
+    bool (*erase_sector)(void *ctx, uint32_t offset);
+    void *ctx;
+    uint32_t size; // Tamanho da partição (múltiplo do setor).
+} reading_log_flash_t;
+
+typedef struct {
+    uint16_t setor;
+    uint16_t slot;
+} reading_log_pos_t;
+
+typedef struct {
+    reading_log_flash_t flash;
+    uint16_t n_setores;
+    uint32_t seq_setor;          // Seq do setor em que se está escrevendo.
+    reading_log_pos_t escrita;   // Próximo slot livre.
+    reading_log_pos_t leitura;   // Primeiro registro ainda não reenviado.
+    uint32_t pendentes;
+    uint32_t descartados;        // Registros perdidos porque o log encheu.
+} reading_log_t;
+
+// Abre o log, reconstruindo as posições a partir da flash (ou formatando se estiver vazia).
+bool reading_log_open(reading_log_t *log, const reading_log_flash_t *flash);
+
+// Acrescenta uma leitura. Se o log estiver cheio, o setor mais antigo é descartado.
+bool reading_log_append(reading_log_t *log, const telemetry_reading_t *leitura);
+
+// Copia até max registros pendentes, do mais antigo para o mais novo, sem consumi-los.
+size_t reading_log_peek(reading_log_t *log, telemetry_reading_t *saida, size_t max);
+
+// Marca os n registros pendentes mais antigos como reenviados.
+bool reading_log_consume(reading_log_t *log, size_t n);
+
+static inline uint32_t reading_log_pending(const reading_log_t *log) {
+    return log->pendentes;
+}
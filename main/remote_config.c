@@ -0,0 +1,412 @@
+#include "remote_config.h"
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "nvs.h"
+#include "esp_log.h"
+#include "sensor_table.h"
+#include "sensor_adc.h"
+#include "telegram_notifier.h"
+#include "metrics.h"
+
+static const char *TAG = "REMOTE_CONFIG";
+
+typedef enum {
+    CMD_SET_TIPO,
+    CMD_CONFIG,
+    CMD_CALIBRAR,
+    CMD_CALIBRAR_LIMPAR,
+    CMD_INVALIDO,
+} cmd_tipo_t;
+
+typedef struct {
+    cmd_tipo_t tipo;
+    uint8_t sensor;
+    uint8_t rota;
+    union {
+        uint8_t tipo_planta;        // CMD_SET_TIPO: índice em TIPOS_PLANTA.
+        struct {
+            int16_t threshold;      // -1 = sem alteração.
+            int16_t histerese;      // -1 = sem alteração.
+            uint32_t intervalo_s;   // 0 = sem alteração.
+        } config;
+        struct {
+            int16_t raw;            // -1 = usar a leitura atual do sensor.
+            uint8_t percent;
+        } ponto;
+        char payload[32];           // CMD_INVALIDO: início do comando, para a resposta.
+    };
+} remote_config_cmd_t;
+
+typedef bool (*parse_fn_t)(const char *dados, size_t len, remote_config_cmd_t *cmd);
+
+typedef struct {
+    const char *sufixo;
+    parse_fn_t parse;
+    const char *uso;    // Enviado no aviso de comando inválido.
+} rota_t;
+
+typedef struct {
+    const char *nome;
+    int threshold;
+    const char *descricao;
+} tipo_planta_t;
+
+static const tipo_planta_t TIPOS_PLANTA[] = {
+    { "padrao",    35, "Planta Padrão" },
+    { "cacto",     20, "Cacto/Suculenta" },
+    { "samambaia", 50, "Samambaia (Amante de Água)" },
+};
+
+static bool parse_set_tipo(const char *dados, size_t len, remote_config_cmd_t *cmd);
+static bool parse_config(const char *dados, size_t len, remote_config_cmd_t *cmd);
+static bool parse_calibrar(const char *dados, size_t len, remote_config_cmd_t *cmd);
+
+static const rota_t ROTAS[] = {
+    { "/set_tipo", parse_set_tipo, "Use 'padrao', 'cacto' ou 'samambaia'." },
+    { "/config",   parse_config,   "Use 'threshold=<0-100>;histerese=<0-50>;intervalo=<segundos>'." },
+    { "/calibrar", parse_calibrar, "Use '<umidade>', '<leitura>=<umidade>' ou 'limpar'." },
+};
+#define N_ROTAS (sizeof(ROTAS) / sizeof(ROTAS[0]))
+
+static QueueHandle_t s_fila;
+static volatile uint32_t s_intervalo_s;
+static bool s_intervalo_pendente;
+static bool s_pendente;              // Há alterações ainda não gravadas na NVS.
+static volatile uint32_t s_recebidos;  // Escrito só pela tarefa do MQTT.
+static volatile uint32_t s_concluidos; // Escrito só pela tarefa de configuração.
+
+// Remontagem de mensagens fragmentadas (só a tarefa do MQTT mexe nestes campos).
+static char s_montagem[REMOTE_CONFIG_PAYLOAD_MAX];
+static size_t s_montados;
+static const rota_t *s_rota;
+static const sensor_t *s_sensor;
+
+static bool token_igual(const char *p, size_t len, const char *palavra) {
+    return len == strlen(palavra) && memcmp(p, palavra, len) == 0;
+}
+
+// Remove espaços e quebras de linha das pontas (ex.: payload enviado com echo).
+static void aparar(const char **p, size_t *len) {
+    while (*len > 0 && ((*p)[0] == ' ' || (*p)[0] == '\r' || (*p)[0] == '\n' || (*p)[0] == '\t')) {
+        (*p)++;
+        (*len)--;
+    }
+    while (*len > 0 && ((*p)[*len - 1] == ' ' || (*p)[*len - 1] == '\r' || (*p)[*len - 1] == '\n' || (*p)[*len - 1] == '\t')) {
+        (*len)--;
+    }
+}
+
+// Lê um inteiro decimal de p[0..len) sem passar de max.
+static bool parse_uint(const char *p, size_t len, uint32_t max, uint32_t *valor) {
+    if (len == 0) return false;
+    uint32_t v = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (p[i] < '0' || p[i] > '9') return false;
+        v = v * 10 + (uint32_t)(p[i] - '0');
+        if (v > max) return false;
+    }
+    *valor = v;
+    return true;
+}
+
+static bool parse_set_tipo(const char *dados, size_t len, remote_config_cmd_t *cmd) {
+    for (size_t i = 0; i < sizeof(TIPOS_PLANTA) / sizeof(TIPOS_PLANTA[0]); i++) {
+        if (token_igual(dados, len, TIPOS_PLANTA[i].nome)) {
+            cmd->tipo = CMD_SET_TIPO;
+            cmd->tipo_planta = (uint8_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// "chave=valor" separados por ';' ou ','.
+static bool parse_config(const char *dados, size_t len, remote_config_cmd_t *cmd) {
+    cmd->tipo = CMD_CONFIG;
+    cmd->config.threshold = -1;
+    cmd->config.histerese = -1;
+    cmd->config.intervalo_s = 0;
+    bool algum = false;
+    const char *fim = dados + len;
+    while (dados < fim) {
+        const char *sep = dados;
+        while (sep < fim && *sep != ';' && *sep != ',') sep++;
+        const char *igual = memchr(dados, '=', (size_t)(sep - dados));
+        if (igual == NULL) return false;
+
+        const char *chave = dados;
+        size_t len_chave = (size_t)(igual - dados);
+        const char *valor = igual + 1;
+        size_t len_valor = (size_t)(sep - valor);
+        aparar(&chave, &len_chave);
+        aparar(&valor, &len_valor);
+        uint32_t v;
+        if (token_igual(chave, len_chave, "threshold") && parse_uint(valor, len_valor, 100, &v)) {
+            cmd->config.threshold = (int16_t)v;
+        } else if (token_igual(chave, len_chave, "histerese") && parse_uint(valor, len_valor, 50, &v)) {
+            cmd->config.histerese = (int16_t)v;
+        } else if (token_igual(chave, len_chave, "intervalo") && parse_uint(valor, len_valor, REMOTE_CONFIG_INTERVALO_MAX_S, &v) &&
+                   v >= REMOTE_CONFIG_INTERVALO_MIN_S) {
+            cmd->config.intervalo_s = v;
+        } else {
+            return false;
+        }
+        algum = true;
+        dados = sep < fim ? sep + 1 : fim;
+    }
+    return algum;
+}
+
+static bool parse_calibrar(const char *dados, size_t len, remote_config_cmd_t *cmd) {
+    if (token_igual(dados, len, "limpar")) {
+        cmd->tipo = CMD_CALIBRAR_LIMPAR;
+        return true;
+    }
+    uint32_t raw, percent;
+    const char *igual = memchr(dados, '=', len);
+    if (igual == NULL) {
+        if (!parse_uint(dados, len, 100, &percent)) return false;
+        cmd->ponto.raw = -1;
+    } else {
+        if (!parse_uint(dados, (size_t)(igual - dados), CALIBRATION_LUT_SIZE - 1, &raw)) return false;
+        if (!parse_uint(igual + 1, len - (size_t)(igual + 1 - dados), 100, &percent)) return false;
+        cmd->ponto.raw = (int16_t)raw;
+    }
+    cmd->tipo = CMD_CALIBRAR;
+    cmd->ponto.percent = (uint8_t)percent;
+    return true;
+}
+
+// Interpreta o payload completo e entrega o comando para a tarefa de configuração.
+static void despachar(const rota_t *rota, const sensor_t *sensor, const char *dados, size_t len) {
+    remote_config_cmd_t cmd = {
+        .sensor = (uint8_t)sensor_table_index(sensor),
+        .rota = (uint8_t)(rota - ROTAS),
+    };
+    aparar(&dados, &len);
+    if (!rota->parse(dados, len, &cmd)) {
+        size_t n = len < sizeof(cmd.payload) - 1 ? len : sizeof(cmd.payload) - 1;
+        cmd.tipo = CMD_INVALIDO;
+        memcpy(cmd.payload, dados, n);
+        cmd.payload[n] = '\0';
+    }
+    s_recebidos++;
+    if (xQueueSend(s_fila, &cmd, 0) != pdTRUE) {
+        s_recebidos--;
+        ESP_LOGW(TAG, "Fila de configuração cheia; comando descartado.");
+    }
+}
+
+void remote_config_on_data(const esp_mqtt_event_t *event) {
+    const char *dados = event->data;
+    size_t len = (size_t)event->data_len;
+
+    if (event->current_data_offset == 0) {
+        // O tópico só vem no primeiro fragmento.
+        s_rota = NULL;
+        for (size_t i = 0; i < N_ROTAS && s_rota == NULL; i++) {
+            s_sensor = sensor_table_find_topic(event->topic, (size_t)event->topic_len, ROTAS[i].sufixo);
+            if (s_sensor != NULL) s_rota = &ROTAS[i];
+        }
+        ESP_LOGI(TAG, "Mensagem recebida no tópico %.*s: %.*s", event->topic_len, event->topic, event->data_len, event->data);
+        if (s_rota == NULL) return;
+        if (event->total_data_len <= event->data_len) {
+            despachar(s_rota, s_sensor, dados, len); // Mensagem inteira: interpretada sem cópia.
+            return;
+        }
+        if (event->total_data_len > REMOTE_CONFIG_PAYLOAD_MAX) {
+            ESP_LOGW(TAG, "Comando de %d bytes ignorado (máximo %d).", event->total_data_len, REMOTE_CONFIG_PAYLOAD_MAX);
+            s_rota = NULL;
+            return;
+        }
+        s_montados = 0;
+    } else if (s_rota == NULL || (size_t)event->current_data_offset != s_montados) {
+        return; // Fragmento de uma mensagem ignorada ou fora de ordem.
+    }
+
+    if (s_montados + len > sizeof(s_montagem)) {
+        s_rota = NULL;
+        return;
+    }
+    memcpy(&s_montagem[s_montados], dados, len);
+    s_montados += len;
+    if (s_montados >= (size_t)event->total_data_len) {
+        despachar(s_rota, s_sensor, s_montagem, s_montados);
+        s_rota = NULL;
+    }
+}
+
+void remote_config_subscribe(esp_mqtt_client_handle_t client) {
+    char topico[SENSOR_TOPICO_MAX + 16];
+    for (size_t i = 0; i < sensor_table_count(); i++) {
+        for (size_t r = 0; r < N_ROTAS; r++) {
+            sensor_table_topic(sensor_table_get(i), ROTAS[r].sufixo, topico, sizeof(topico));
+            esp_mqtt_client_subscribe(client, topico, 0);
+            ESP_LOGI(TAG, "Assinando o tópico de configuração: %s", topico);
+        }
+    }
+}
+
+// Aplica o comando na memória e responde no Telegram. Retorna true se algo precisa ir para a NVS.
+static bool aplicar(const remote_config_cmd_t *cmd) {
+    sensor_t *sensor = sensor_table_get(cmd->sensor);
+    char response_msg[200];
+    char rotulo[24];
+    sensor_table_label(sensor, rotulo, sizeof(rotulo));
+
+    switch (cmd->tipo) {
+    case CMD_SET_TIPO: {
+        const tipo_planta_t *tipo = &TIPOS_PLANTA[cmd->tipo_planta];
+        // Apenas atualiza se o novo valor for diferente do atual.
+        if (tipo->threshold == sensor->threshold) {
+            ESP_LOGI(TAG, "O tipo de planta já era o mesmo. Nenhuma alteração feita.");
+            return false;
+        }
+        sensor_table_set_threshold(sensor, tipo->threshold);
+        snprintf(response_msg, sizeof(response_msg), "✅ SoloScan%s reconfigurado!\nTipo: %s\nAlerta de rega abaixo de: %d%%", rotulo, tipo->descricao, sensor->threshold);
+        telegram_notify(response_msg);
+        return true;
+    }
+    case CMD_CONFIG: {
+        bool mudou = false;
+        if (cmd->config.threshold >= 0 && cmd->config.threshold != sensor->threshold) {
+            sensor_table_set_threshold(sensor, cmd->config.threshold);
+            mudou = true;
+        }
+        if (cmd->config.histerese >= 0 && cmd->config.histerese != sensor->histerese) {
+            sensor_table_set_hysteresis(sensor, cmd->config.histerese);
+            mudou = true;
+        }
+        if (cmd->config.intervalo_s > 0 && cmd->config.intervalo_s != s_intervalo_s) {
+            s_intervalo_s = cmd->config.intervalo_s;
+            s_intervalo_pendente = true;
+            mudou = true;
+        }
+        if (!mudou) {
+            ESP_LOGI(TAG, "Configuração igual à atual. Nenhuma alteração feita.");
+            return false;
+        }
+        snprintf(response_msg, sizeof(response_msg), "✅ SoloScan%s reconfigurado!\nAlerta de rega abaixo de: %d%%\nHisterese: %d%%\nIntervalo de leitura: %u s",
+                 rotulo, sensor->threshold, sensor->histerese, (unsigned)s_intervalo_s);
+        telegram_notify(response_msg);
+        return true;
+    }
+    case CMD_CALIBRAR: {
+        int raw = cmd->ponto.raw;
+        if (raw < 0) {
+            sensor_reading_t leitura;
+            if (sensor_adc_get(cmd->sensor, &leitura) != ESP_OK) {
+                snprintf(response_msg, sizeof(response_msg), "⚠️ SoloScan%s: Nenhuma leitura do sensor disponível para calibrar.", rotulo);
+                telegram_notify(response_msg);
+                return false;
+            }
+            raw = leitura.filtrado;
+        }
+        if (sensor_table_add_calibration_point(sensor, (uint16_t)raw, cmd->ponto.percent) != ESP_OK) {
+            snprintf(response_msg, sizeof(response_msg), "⚠️ SoloScan%s: O ponto %d=%u%% não foi aceito (curva cheia ou fora de ordem). Envie 'limpar' para recomeçar.", rotulo, raw, cmd->ponto.percent);
+            telegram_notify(response_msg);
+            return false;
+        }
+        snprintf(response_msg, sizeof(response_msg), "✅ SoloScan%s: Ponto de calibração %d=%u%% salvo (%u pontos).", rotulo, raw, cmd->ponto.percent, sensor->curva.n);
+        telegram_notify(response_msg);
+        return true;
+    }
+    case CMD_CALIBRAR_LIMPAR:
+        sensor_table_clear_calibration(sensor);
+        snprintf(response_msg, sizeof(response_msg), "✅ SoloScan%s: Calibração restaurada para o padrão.", rotulo);
+        telegram_notify(response_msg);
+        return true;
+    case CMD_INVALIDO:
+    default:
+        // Se o comando for inválido, envia um aviso e não faz nada.
+        ESP_LOGW(TAG, "Comando inválido em %s: %s", ROTAS[cmd->rota].sufixo, cmd->payload);
+        snprintf(response_msg, sizeof(response_msg), "⚠️ SoloScan%s: Comando '%s' não reconhecido. %s", rotulo, cmd->payload, ROTAS[cmd->rota].uso);
+        telegram_notify(response_msg);
+        return false;
+    }
+}
+
+// Grava tudo que mudou desde o último commit em uma única transação da NVS.
+static void gravar(uint32_t comandos) {
+    int64_t inicio_us = metrics_start();
+    nvs_handle_t my_handle;
+    esp_err_t err = nvs_open("storage", NVS_READWRITE, &my_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Erro (%s) abrindo NVS para escrita!", esp_err_to_name(err));
+        return;
+    }
+    size_t gravados = sensor_table_commit(my_handle);
+    if (s_intervalo_pendente && nvs_set_u32(my_handle, "intervalo", s_intervalo_s) == ESP_OK) {
+        s_intervalo_pendente = false;
+        gravados++;
+    }
+    err = nvs_commit(my_handle);
+    nvs_close(my_handle);
+    metrics_record_since(METRIC_NVS_COMMIT, inicio_us);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "%u valores de %u comandos salvos na memória NVS em um único commit.", (unsigned)gravados, (unsigned)comandos);
+    } else {
+        ESP_LOGE(TAG, "Falha ao salvar a configuração na NVS!");
+    }
+}
+
+static void remote_config_task(void *arg) {
+    remote_config_cmd_t cmd;
+    TickType_t pendente_desde = 0;
+    uint32_t comandos = 0;
+
+    while (1) {
+        TickType_t espera = portMAX_DELAY;
+        if (s_pendente) {
+            // Espera a rajada de comandos acabar, mas não adia a gravação para sempre.
+            TickType_t decorrido = xTaskGetTickCount() - pendente_desde;
+            TickType_t prazo = pdMS_TO_TICKS(REMOTE_CONFIG_COMMIT_MAX_MS);
+            espera = decorrido >= prazo ? 0 : prazo - decorrido;
+            if (espera > pdMS_TO_TICKS(REMOTE_CONFIG_COMMIT_MS)) espera = pdMS_TO_TICKS(REMOTE_CONFIG_COMMIT_MS);
+        }
+        if (xQueueReceive(s_fila, &cmd, espera) == pdTRUE) {
+            if (aplicar(&cmd)) {
+                if (!s_pendente) pendente_desde = xTaskGetTickCount();
+                s_pendente = true;
+                comandos++;
+            }
+            s_concluidos++;
+            continue;
+        }
+        gravar(comandos);
+        comandos = 0;
+        s_pendente = false;
+    }
+}
+
+esp_err_t remote_config_init(uint32_t intervalo_padrao_ms) {
+    s_intervalo_s = intervalo_padrao_ms / 1000;
+    nvs_handle_t my_handle;
+    if (nvs_open("storage", NVS_READONLY, &my_handle) == ESP_OK) {
+        uint32_t intervalo_s;
+        if (nvs_get_u32(my_handle, "intervalo", &intervalo_s) == ESP_OK &&
+            intervalo_s >= REMOTE_CONFIG_INTERVALO_MIN_S && intervalo_s <= REMOTE_CONFIG_INTERVALO_MAX_S) {
+            s_intervalo_s = intervalo_s;
+            ESP_LOGI(TAG, "Intervalo de leitura (%u s) carregado da memória NVS.", (unsigned)s_intervalo_s);
+        }
+        nvs_close(my_handle);
+    }
+
+    s_fila = xQueueCreate(REMOTE_CONFIG_FILA_TAMANHO, sizeof(remote_config_cmd_t));
+    if (s_fila == NULL) return ESP_ERR_NO_MEM;
+    if (xTaskCreate(remote_config_task, "remote_config", 4096, NULL, 4, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+uint32_t remote_config_interval_ms(void) {
+    return s_intervalo_s * 1000;
+}
+
+bool remote_config_idle(void) {
+    return s_recebidos == s_concluidos && !s_pendente;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Comandos de configuração recebidos por MQTT.
+// O tratador de eventos do MQTT só escolhe a rota pelo tópico e interpreta o payload no próprio
+// buffer do cliente (mensagens fragmentadas são remontadas em um buffer fixo). O comando pronto
+// vai por uma fila para a tarefa de configuração, que aplica a mudança, responde no Telegram e
+// grava a NVS uma única vez depois que os comandos param de chegar.
+//
+// Tópicos de cada vaso (tópico do vaso + sufixo):
+//   /set_tipo  "padrao" | "cacto" | "samambaia"
+//   /config    "threshold=30;histerese=3;intervalo=60" (qualquer subconjunto; o intervalo vale para o dispositivo)
+//   /calibrar  "40" (leitura atual = 40%) | "2100=40" | "limpar"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "mqtt_client.h"
+
+#define REMOTE_CONFIG_PAYLOAD_MAX       256    // Maior payload aceito (somando os fragmentos).
+#define REMOTE_CONFIG_FILA_TAMANHO      8      // Comandos aguardando a tarefa de configuração.
+#define REMOTE_CONFIG_COMMIT_MS         2000   // Tempo sem novos comandos antes de gravar a NVS.
+#define REMOTE_CONFIG_COMMIT_MAX_MS     10000  // Prazo máximo para gravar, mesmo com comandos chegando.
+#define REMOTE_CONFIG_INTERVALO_MIN_S   5
+#define REMOTE_CONFIG_INTERVALO_MAX_S   86400
+
+// Carrega o intervalo de leitura da NVS e cria a fila e a tarefa de configuração.
+// A tabela de sensores já precisa estar inicializada.
+esp_err_t remote_config_init(uint32_t intervalo_padrao_ms);
+
+// Assina os tópicos de comando de todos os vasos (chamar a cada MQTT_EVENT_CONNECTED).
+void remote_config_subscribe(esp_mqtt_client_handle_t client);
+
+// Trata um MQTT_EVENT_DATA. Roda na tarefa do MQTT e nunca bloqueia.
+void remote_config_on_data(const esp_mqtt_event_t *event);
+
+// Intervalo entre leituras atualmente configurado.
+uint32_t remote_config_interval_ms(void);
+
+// True quando não há comando na fila nem gravação pendente (usado antes de dormir).
+bool remote_config_idle(void);
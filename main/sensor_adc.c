@@ -0,0 +1,167 @@
+#include "sensor_adc.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "sensor_filter.h"
+#include "metrics.h"
+
+static const char *TAG = "SENSOR_ADC";
+
+static adc_continuous_handle_t s_adc_handle;
+static TaskHandle_t s_adc_task;
+static size_t s_n_canais;
+static int8_t s_indice_do_canal[SOC_ADC_CHANNEL_NUM(ADC_UNIT_1)]; // -1 para canais fora da tabela.
+
+static uint16_t s_janelas[SENSOR_ADC_MAX_CANAIS][SENSOR_ADC_WINDOW_SAMPLES];
+static size_t s_preenchidas[SENSOR_ADC_MAX_CANAIS];
+// O estado do IIR fica na memória RTC para continuar suavizando entre despertares do deep sleep.
+static RTC_DATA_ATTR sensor_iir_t s_iir[SENSOR_ADC_MAX_CANAIS];
+static sensor_reading_t s_ultimas_leituras[SENSOR_ADC_MAX_CANAIS];
+static uint32_t s_varredura_us;
+static SemaphoreHandle_t s_nova_leitura;
+static portMUX_TYPE s_leitura_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Chamado pelo driver (em ISR) sempre que um quadro de DMA fica pronto.
+static bool IRAM_ATTR sensor_adc_conv_done(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *user_data) {
+    BaseType_t acordar = pdFALSE;
+    vTaskNotifyGiveFromISR(s_adc_task, &acordar);
+    return acordar == pdTRUE;
+}
+
+// Esvazia os quadros disponíveis no anel de DMA, separando as amostras na janela de cada canal.
+// Retorna quantos canais ainda não completaram a janela.
+static size_t sensor_adc_drain(uint8_t *quadro, size_t incompletos) {
+    uint32_t lidos = 0;
+    while (incompletos > 0 &&
+           adc_continuous_read(s_adc_handle, quadro, SENSOR_ADC_FRAME_BYTES, &lidos, 0) == ESP_OK) {
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= lidos; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            adc_digi_output_data_t *p = (adc_digi_output_data_t *)&quadro[i];
+            if (p->type1.channel >= SOC_ADC_CHANNEL_NUM(ADC_UNIT_1)) continue;
+            int indice = s_indice_do_canal[p->type1.channel];
+            if (indice < 0 || s_preenchidas[indice] >= SENSOR_ADC_WINDOW_SAMPLES) continue;
+            s_janelas[indice][s_preenchidas[indice]++] = p->type1.data;
+            if (s_preenchidas[indice] == SENSOR_ADC_WINDOW_SAMPLES) incompletos--;
+        }
+    }
+    return incompletos;
+}
+
+static void sensor_adc_task(void *arg) {
+    static uint8_t quadro[SENSOR_ADC_FRAME_BYTES];
+
+    while (1) {
+        // Uma varredura: o padrão do ADC percorre todos os canais da tabela na mesma passada de DMA.
+        int64_t inicio_us = esp_timer_get_time();
+        size_t incompletos = s_n_canais;
+        memset(s_preenchidas, 0, sizeof(s_preenchidas));
+        ESP_ERROR_CHECK(adc_continuous_start(s_adc_handle));
+        while (incompletos > 0) {
+            // A tarefa fica bloqueada até o DMA entregar um quadro; nada de espera ativa.
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100)) == 0) {
+                ESP_LOGW(TAG, "Timeout esperando quadro do ADC.");
+                continue;
+            }
+            incompletos = sensor_adc_drain(quadro, incompletos);
+        }
+        // Desliga o ADC entre janelas e descarta o que sobrou no anel.
+        ESP_ERROR_CHECK(adc_continuous_stop(s_adc_handle));
+        adc_continuous_flush_pool(s_adc_handle);
+
+        for (size_t c = 0; c < s_n_canais; c++) {
+            uint16_t media = sensor_filter_mean(s_janelas[c], SENSOR_ADC_WINDOW_SAMPLES);
+            uint16_t mediana = sensor_filter_median(s_janelas[c], SENSOR_ADC_WINDOW_SAMPLES);
+            uint16_t filtrado = sensor_iir_update(&s_iir[c], mediana);
+
+            portENTER_CRITICAL(&s_leitura_lock);
+            s_ultimas_leituras[c].media = media;
+            s_ultimas_leituras[c].mediana = mediana;
+            s_ultimas_leituras[c].filtrado = filtrado;
+            s_ultimas_leituras[c].janela++;
+            portEXIT_CRITICAL(&s_leitura_lock);
+        }
+        s_varredura_us = (uint32_t)(esp_timer_get_time() - inicio_us);
+        metrics_record(METRIC_ADC_SCAN, s_varredura_us);
+        xSemaphoreGive(s_nova_leitura);
+
+        ESP_LOGD(TAG, "Varredura de %u canais em %u us.", (unsigned)s_n_canais, (unsigned)s_varredura_us);
+        vTaskDelay(pdMS_TO_TICKS(SENSOR_ADC_PERIOD_MS));
+    }
+}
+
+esp_err_t sensor_adc_init(const board_channel_t *canais, size_t n) {
+    if (n == 0 || n > SENSOR_ADC_MAX_CANAIS) return ESP_ERR_INVALID_ARG;
+    s_n_canais = n;
+    memset(s_indice_do_canal, -1, sizeof(s_indice_do_canal));
+    bool despertou = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+    for (size_t c = 0; c < n; c++) {
+        s_indice_do_canal[canais[c]] = (int8_t)c;
+        if (!despertou) sensor_iir_init(&s_iir[c], SENSOR_ADC_IIR_SHIFT);
+    }
+    memset(s_ultimas_leituras, 0, sizeof(s_ultimas_leituras));
+    s_nova_leitura = xSemaphoreCreateBinary();
+    if (s_nova_leitura == NULL) return ESP_ERR_NO_MEM;
+
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = SENSOR_ADC_FRAME_BYTES * 4,
+        .conv_frame_size = SENSOR_ADC_FRAME_BYTES,
+    };
+    esp_err_t err = adc_continuous_new_handle(&handle_cfg, &s_adc_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Erro (%s) criando o ADC contínuo!", esp_err_to_name(err));
+        return err;
+    }
+
+    adc_digi_pattern_config_t padrao[SENSOR_ADC_MAX_CANAIS] = {0};
+    for (size_t c = 0; c < n; c++) {
+        padrao[c].atten = ADC_ATTEN_DB_12;
+        padrao[c].channel = canais[c];
+        padrao[c].unit = ADC_UNIT_1;
+        padrao[c].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+    adc_continuous_config_t dig_cfg = {
+        .pattern_num = n,
+        .adc_pattern = padrao,
+        .sample_freq_hz = SENSOR_ADC_SAMPLE_FREQ_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    };
+    err = adc_continuous_config(s_adc_handle, &dig_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Erro (%s) configurando o ADC contínuo!", esp_err_to_name(err));
+        return err;
+    }
+
+    // O callback precisa ser registrado antes de a tarefa ligar o ADC.
+    adc_continuous_evt_cbs_t cbs = { .on_conv_done = sensor_adc_conv_done, };
+    err = adc_continuous_register_event_callbacks(s_adc_handle, &cbs, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Erro (%s) registrando o callback do ADC!", esp_err_to_name(err));
+        return err;
+    }
+    if (xTaskCreate(sensor_adc_task, "sensor_adc", 3072, NULL, 5, &s_adc_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sensor_adc_get(size_t indice, sensor_reading_t *leitura) {
+    if (indice >= s_n_canais) return ESP_ERR_INVALID_ARG;
+    portENTER_CRITICAL(&s_leitura_lock);
+    *leitura = s_ultimas_leituras[indice];
+    portEXIT_CRITICAL(&s_leitura_lock);
+    return leitura->janela == 0 ? ESP_ERR_NOT_FOUND : ESP_OK;
+}
+
+esp_err_t sensor_adc_wait(TickType_t espera) {
+    return xSemaphoreTake(s_nova_leitura, espera) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+uint32_t sensor_adc_last_scan_us(void) {
+    return s_varredura_us;
+}
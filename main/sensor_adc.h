@@ -0,0 +1,39 @@
+#pragma once
+
+// Amostragem contínua do sensor usando o driver ADC com DMA do ESP-IDF.
+// Uma tarefa em segundo plano acorda a cada quadro de DMA concluído, separa as
+// amostras de cada canal em uma janela e reduz cada janela para um valor filtrado.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "board.h"
+
+#define SENSOR_ADC_SAMPLE_FREQ_HZ   20000 // Frequência mínima do modo contínuo no ESP32.
+#define SENSOR_ADC_FRAME_BYTES      256   // Tamanho de cada quadro de DMA.
+#define SENSOR_ADC_MAX_CANAIS       8     // Todos os canais do ADC1.
+#define SENSOR_ADC_WINDOW_SAMPLES   256   // Amostras reduzidas a cada janela, por canal.
+#define SENSOR_ADC_PERIOD_MS        1000  // Intervalo entre janelas (o ADC fica parado nesse tempo).
+#define SENSOR_ADC_IIR_SHIFT        3     // Suavização entre janelas (alfa = 1/8).
+
+typedef struct {
+    uint16_t media;     // Média sobreamostrada da janela.
+    uint16_t mediana;   // Mediana da janela (robusta a picos).
+    uint16_t filtrado;  // Saída do IIR alimentado pela mediana de cada janela.
+    uint32_t janela;    // Número de varreduras processadas desde o início.
+} sensor_reading_t;
+
+// Configura o ADC1 em modo contínuo para varrer os n canais informados e inicia a tarefa de amostragem.
+// As leituras são indexadas pela posição do canal nesse vetor.
+esp_err_t sensor_adc_init(const board_channel_t *canais, size_t n);
+
+// Copia a última leitura filtrada do canal de índice informado.
+// Retorna ESP_ERR_NOT_FOUND se nenhuma varredura terminou ainda.
+esp_err_t sensor_adc_get(size_t indice, sensor_reading_t *leitura);
+
+// Espera a próxima varredura (todos os canais) terminar.
+esp_err_t sensor_adc_wait(TickType_t espera);
+
+// Duração da última varredura, em microssegundos.
+uint32_t sensor_adc_last_scan_us(void);
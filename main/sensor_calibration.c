@@ -0,0 +1,66 @@
+#include "sensor_calibration.h"
+#include <string.h>
+
+void calibration_curve_default(calibration_curve_t *curva, uint16_t min_molhado, uint16_t max_seco) {
+    curva->pontos[0] = (calibration_point_t){ .raw = min_molhado, .percent = 100 };
+    curva->pontos[1] = (calibration_point_t){ .raw = max_seco, .percent = 0 };
+    curva->n = 2;
+}
+
+bool calibration_curve_valid(const calibration_curve_t *curva) {
+    if (curva->n < 2 || curva->n > CALIBRATION_MAX_POINTS) return false;
+    int direcao = 0; // -1 decrescente, +1 crescente, 0 ainda plana.
+    for (size_t i = 0; i < curva->n; i++) {
+        if (curva->pontos[i].raw >= CALIBRATION_LUT_SIZE || curva->pontos[i].percent > 100) return false;
+        if (i == 0) continue;
+        if (curva->pontos[i].raw <= curva->pontos[i - 1].raw) return false;
+        int passo = (int)curva->pontos[i].percent - (int)curva->pontos[i - 1].percent;
+        if (passo == 0) continue;
+        if (direcao != 0 && (passo > 0) != (direcao > 0)) return false;
+        direcao = passo > 0 ? 1 : -1;
+    }
+    return true;
+}
+
+bool calibration_curve_add(calibration_curve_t *curva, uint16_t raw, uint8_t percent) {
+    if (raw >= CALIBRATION_LUT_SIZE || percent > 100) return false;
+    calibration_curve_t nova = *curva;
+    size_t i = 0;
+    while (i < nova.n && nova.pontos[i].raw < raw) i++;
+    if (i < nova.n && nova.pontos[i].raw == raw) {
+        nova.pontos[i].percent = percent;
+    } else {
+        if (nova.n >= CALIBRATION_MAX_POINTS) return false;
+        memmove(&nova.pontos[i + 1], &nova.pontos[i], (nova.n - i) * sizeof(nova.pontos[0]));
+        nova.pontos[i] = (calibration_point_t){ .raw = raw, .percent = percent };
+        nova.n++;
+    }
+    // Com menos de dois pontos ainda não há o que verificar.
+    if (nova.n >= 2 && !calibration_curve_valid(&nova)) return false;
+    *curva = nova;
+    return true;
+}
+
+bool calibration_build_lut(const calibration_curve_t *curva, uint8_t *lut) {
+    if (!calibration_curve_valid(curva)) return false;
+    const calibration_point_t *p = curva->pontos;
+    size_t trecho = 0;
+    for (int32_t raw = 0; raw < CALIBRATION_LUT_SIZE; raw++) {
+        if (raw <= p[0].raw) {
+            lut[raw] = p[0].percent;
+            continue;
+        }
+        while (trecho + 1 < curva->n && raw > p[trecho + 1].raw) trecho++;
+        if (trecho + 1 >= curva->n) {
+            lut[raw] = p[curva->n - 1].percent;
+            continue;
+        }
+        // Interpolação linear no trecho, arredondada para o inteiro mais próximo.
+        int32_t dx = p[trecho + 1].raw - p[trecho].raw;
+        int32_t dy = (int32_t)p[trecho + 1].percent - p[trecho].percent;
+        int32_t num = 2 * (raw - p[trecho].raw) * dy;
+        num += dy >= 0 ? dx : -dx;
+        lut[raw] = (uint8_t)(p[trecho].percent + num / (2 * dx));
+    }
+    return true;
+}
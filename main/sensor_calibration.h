@@ -0,0 +1,44 @@
+#pragma once
+
+// Curva de calibração do sensor em vários pontos, compilada em uma tabela de consulta.
+// A resposta do sensor capacitivo não é linear, então a curva é interpolada por trechos entre
+// os pontos de referência e a tabela guarda a porcentagem de cada leitura de 12 bits: a conversão
+// vira uma única leitura de memória, sem divisão.
+// Este módulo não depende do ESP-IDF para poder ser compilado e testado no computador.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define CALIBRATION_MAX_POINTS  8
+#define CALIBRATION_LUT_SIZE    4096  // Uma entrada por valor do ADC de 12 bits.
+
+typedef struct {
+    uint16_t raw;      // Leitura do ADC no ponto de referência.
+    uint8_t percent;   // Umidade conhecida nesse ponto, em %.
+} calibration_point_t;
+
+typedef struct {
+    calibration_point_t pontos[CALIBRATION_MAX_POINTS]; // Ordenados por raw, sem repetição.
+    uint8_t n;
+} calibration_curve_t;
+
+// Curva de dois pontos equivalente à calibração antiga (min_molhado = 100%, max_seco = 0%).
+void calibration_curve_default(calibration_curve_t *curva, uint16_t min_molhado, uint16_t max_seco);
+
+// Insere um ponto mantendo a ordem; um ponto com o mesmo raw é substituído.
+// Retorna false se a curva estiver cheia ou se o ponto deixar a curva não monotônica.
+bool calibration_curve_add(calibration_curve_t *curva, uint16_t raw, uint8_t percent);
+
+// Verifica se a curva tem ao menos dois pontos, em ordem, e é monotônica.
+bool calibration_curve_valid(const calibration_curve_t *curva);
+
+// Preenche lut[CALIBRATION_LUT_SIZE]. Fora dos pontos extremos o valor é fixado no extremo.
+// Cada entrada é escrita uma única vez, então quem lê a tabela durante a reconstrução
+// obtém o valor antigo ou o novo, nunca um intermediário.
+// Retorna false (sem tocar na tabela) se a curva for inválida.
+bool calibration_build_lut(const calibration_curve_t *curva, uint8_t *lut);
+
+static inline uint8_t calibration_lookup(const uint8_t *lut, uint16_t raw) {
+    return lut[raw & (CALIBRATION_LUT_SIZE - 1)];
+}
@@ -0,0 +1,79 @@
+#include "sensor_filter.h"
+
+uint16_t sensor_filter_mean(const uint16_t *amostras, size_t n) {
+    if (n == 0) return 0;
+    uint32_t soma = 0;
+    for (size_t i = 0; i < n; i++) {
+        soma += amostras[i];
+    }
+    return (uint16_t)((soma + n / 2) / n);
+}
+
+// Algoritmo de seleção de Wirth: encontra a mediana em O(n) sem ordenar a janela inteira.
+uint16_t sensor_filter_median(uint16_t *amostras, size_t n) {
+    if (n == 0) return 0;
+    const long k = (long)(n / 2);
+    long esq = 0;
+    long dir = (long)n - 1;
+    while (esq < dir) {
+        const uint16_t pivo = amostras[k];
+        long i = esq;
+        long j = dir;
+        do {
+            while (amostras[i] < pivo) i++;
+            while (pivo < amostras[j]) j--;
+            if (i <= j) {
+                uint16_t tmp = amostras[i];
+                amostras[i] = amostras[j];
+                amostras[j] = tmp;
+                i++;
+                j--;
+            }
+        } while (i <= j);
+        if (j < k) esq = i;
+        if (k < i) dir = j;
+    }
+    return amostras[k];
+}
+
+void sensor_iir_init(sensor_iir_t *f, uint8_t shift) {
+    f->acc = 0;
+    f->shift = shift;
+    f->iniciado = false;
+}
+
+uint16_t sensor_iir_update(sensor_iir_t *f, uint16_t x) {
+    if (!f->iniciado) {
+        f->acc = (int32_t)x << f->shift;
+        f->iniciado = true;
+    } else {
+        // acc representa y * 2^shift, então acc += x - y.
+        f->acc += (int32_t)x - (int32_t)sensor_iir_value(f);
+    }
+    return sensor_iir_value(f);
+}
+
+uint16_t sensor_iir_value(const sensor_iir_t *f) {
+    if (f->shift == 0) return (uint16_t)f->acc;
+    return (uint16_t)((f->acc + (1 << (f->shift - 1))) >> f->shift);
+}
+
+void sensor_settle_init(sensor_settle_t *s, uint16_t tolerancia) {
+    s->n = 0;
+    s->pos = 0;
+    s->tolerancia = tolerancia;
+}
+
+bool sensor_settle_update(sensor_settle_t *s, uint16_t x) {
+    s->valores[s->pos] = x;
+    s->pos = (uint8_t)((s->pos + 1) % SENSOR_SETTLE_JANELA);
+    if (s->n < SENSOR_SETTLE_JANELA) s->n++;
+    if (s->n < SENSOR_SETTLE_JANELA) return false;
+
+    uint16_t min = UINT16_MAX, max = 0;
+    for (size_t i = 0; i < SENSOR_SETTLE_JANELA; i++) {
+        if (s->valores[i] < min) min = s->valores[i];
+        if (s->valores[i] > max) max = s->valores[i];
+    }
+    return max - min <= s->tolerancia;
+}
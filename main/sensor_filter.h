@@ -0,0 +1,45 @@
+#pragma once
+
+// Núcleos de filtragem das leituras do sensor.
+// Este módulo não depende do ESP-IDF para poder ser compilado e testado no computador.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define SENSOR_SETTLE_JANELA 16  // Leituras consideradas pelo detector de estabilização.
+
+// Filtro IIR de primeira ordem em ponto fixo: y += (x - y) / 2^shift.
+typedef struct {
+    int32_t acc;     // Estado interno, escalado por 2^shift.
+    uint8_t shift;   // Constante de tempo do filtro (alfa = 1 / 2^shift).
+    bool iniciado;   // Falso até a primeira amostra, que inicializa o estado diretamente.
+} sensor_iir_t;
+
+// Detector de estabilização: o sinal é considerado estável quando as últimas
+// SENSOR_SETTLE_JANELA leituras cabem em uma faixa de no máximo 'tolerancia' contagens.
+typedef struct {
+    uint16_t valores[SENSOR_SETTLE_JANELA];
+    uint8_t n;
+    uint8_t pos;
+    uint16_t tolerancia;
+} sensor_settle_t;
+
+// Média das amostras com arredondamento (sobreamostragem de uma janela).
+uint16_t sensor_filter_mean(const uint16_t *amostras, size_t n);
+
+// Mediana das amostras. ATENÇÃO: reordena o vetor recebido.
+uint16_t sensor_filter_median(uint16_t *amostras, size_t n);
+
+void sensor_iir_init(sensor_iir_t *f, uint8_t shift);
+
+// Alimenta o filtro com uma nova amostra e retorna o valor filtrado.
+uint16_t sensor_iir_update(sensor_iir_t *f, uint16_t x);
+
+// Valor atual do filtro, sem alimentá-lo.
+uint16_t sensor_iir_value(const sensor_iir_t *f);
+
+void sensor_settle_init(sensor_settle_t *s, uint16_t tolerancia);
+
+// Acrescenta uma leitura e retorna true se a janela está cheia e dentro da tolerância.
+bool sensor_settle_update(sensor_settle_t *s, uint16_t x);
@@ -0,0 +1,197 @@
+#include "sensor_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+
+static const char *TAG = "SENSOR_TABLE";
+
+static sensor_t s_sensores[SENSOR_TABLE_MAX];
+static size_t s_n_sensores;
+
+// O primeiro sensor usa a chave original "threshold" para manter a configuração de quem já tinha um só vaso.
+static void nvs_key_threshold(size_t indice, char *chave, size_t len) {
+    if (indice == 0) {
+        snprintf(chave, len, "threshold");
+    } else {
+        snprintf(chave, len, "threshold%u", (unsigned)indice);
+    }
+}
+
+// Monta a tabela de conversão a partir dos pontos capturados ou, se não houver, da calibração padrão.
+static void rebuild_lut(sensor_t *sensor) {
+    calibration_curve_t padrao;
+    const calibration_curve_t *curva = &sensor->curva;
+    if (!calibration_curve_valid(curva)) {
+        calibration_curve_default(&padrao, sensor->config->min_molhado, sensor->config->max_seco);
+        curva = &padrao;
+    }
+    if (!calibration_build_lut(curva, sensor->lut)) {
+        ESP_LOGE(TAG, "Calibração inválida para o sensor %u!", (unsigned)sensor_table_index(sensor));
+    }
+}
+
+esp_err_t sensor_table_init(const sensor_config_t *configs, size_t n, const char *topico_base) {
+    if (n == 0 || n > SENSOR_TABLE_MAX) return ESP_ERR_INVALID_ARG;
+    s_n_sensores = n;
+    for (size_t i = 0; i < n; i++) {
+        s_sensores[i].config = &configs[i];
+        s_sensores[i].threshold = configs[i].threshold;
+        s_sensores[i].histerese = configs[i].histerese;
+        snprintf(s_sensores[i].topico, sizeof(s_sensores[i].topico), "%s%s", topico_base, configs[i].sufixo);
+        s_sensores[i].curva.n = 0;
+        s_sensores[i].pendente = 0;
+        // 4 KB por vaso, alocados só para os vasos configurados.
+        s_sensores[i].lut = malloc(CALIBRATION_LUT_SIZE);
+        if (s_sensores[i].lut == NULL) return ESP_ERR_NO_MEM;
+        rebuild_lut(&s_sensores[i]);
+    }
+    return ESP_OK;
+}
+
+size_t sensor_table_count(void) {
+    return s_n_sensores;
+}
+
+sensor_t *sensor_table_get(size_t indice) {
+    return indice < s_n_sensores ? &s_sensores[indice] : NULL;
+}
+
+size_t sensor_table_index(const sensor_t *sensor) {
+    return (size_t)(sensor - s_sensores);
+}
+
+void sensor_table_topic(const sensor_t *sensor, const char *sufixo, char *saida, size_t len) {
+    snprintf(saida, len, "%s%s", sensor->topico, sufixo);
+}
+
+void sensor_table_label(const sensor_t *sensor, char *saida, size_t len) {
+    if (sensor->config->nome[0] != '\0') {
+        snprintf(saida, len, " (%s)", sensor->config->nome);
+    } else {
+        saida[0] = '\0';
+    }
+}
+
+sensor_t *sensor_table_find_topic(const char *topico, size_t len, const char *sufixo) {
+    size_t len_sufixo = strlen(sufixo);
+    for (size_t i = 0; i < s_n_sensores; i++) {
+        size_t len_base = strlen(s_sensores[i].topico);
+        if (len == len_base + len_sufixo &&
+            memcmp(topico, s_sensores[i].topico, len_base) == 0 &&
+            memcmp(topico + len_base, sufixo, len_sufixo) == 0) {
+            return &s_sensores[i];
+        }
+    }
+    return NULL;
+}
+
+// lê a configuração de cada sensor da memória NVS quando o ESP32 liga
+void sensor_table_load(void) {
+    nvs_handle_t my_handle;
+    esp_err_t err = nvs_open("storage", NVS_READONLY, &my_handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "NVS não encontrada. Usando configuração padrão.");
+        return;
+    }
+    for (size_t i = 0; i < s_n_sensores; i++) {
+        sensor_t *sensor = &s_sensores[i];
+        char chave[16];
+        int32_t required_value;
+
+        nvs_key_threshold(i, chave, sizeof(chave));
+        err = nvs_get_i32(my_handle, chave, &required_value);
+        if (err == ESP_OK) {
+            sensor->threshold = required_value;
+            ESP_LOGI(TAG, "Threshold do sensor %u (%d) carregado da memória NVS.", (unsigned)i, sensor->threshold);
+        } else {
+            ESP_LOGW(TAG, "Nenhum threshold salvo para o sensor %u. Usando padrão (%d).", (unsigned)i, sensor->threshold);
+        }
+
+        snprintf(chave, sizeof(chave), "hist%u", (unsigned)i);
+        if (nvs_get_i32(my_handle, chave, &required_value) == ESP_OK) {
+            sensor->histerese = required_value;
+        }
+
+        snprintf(chave, sizeof(chave), "cal%u", (unsigned)i);
+        calibration_curve_t curva = {0};
+        size_t tamanho = sizeof(curva.pontos);
+        if (nvs_get_blob(my_handle, chave, curva.pontos, &tamanho) == ESP_OK) {
+            curva.n = (uint8_t)(tamanho / sizeof(curva.pontos[0]));
+            if (curva.n < 2 || calibration_curve_valid(&curva)) {
+                sensor->curva = curva;
+                ESP_LOGI(TAG, "Calibração do sensor %u com %u pontos carregada da memória NVS.", (unsigned)i, curva.n);
+            } else {
+                ESP_LOGW(TAG, "Calibração salva do sensor %u é inválida. Usando padrão.", (unsigned)i);
+            }
+        }
+        rebuild_lut(sensor);
+    }
+    nvs_close(my_handle);
+}
+
+void sensor_table_set_threshold(sensor_t *sensor, int threshold) {
+    sensor->threshold = threshold;
+    sensor->pendente |= SENSOR_PENDENTE_THRESHOLD;
+}
+
+void sensor_table_set_hysteresis(sensor_t *sensor, int histerese) {
+    sensor->histerese = histerese;
+    sensor->pendente |= SENSOR_PENDENTE_HISTERESE;
+}
+
+esp_err_t sensor_table_add_calibration_point(sensor_t *sensor, uint16_t raw, uint8_t percent) {
+    if (!calibration_curve_add(&sensor->curva, raw, percent)) return ESP_ERR_INVALID_ARG;
+    rebuild_lut(sensor);
+    sensor->pendente |= SENSOR_PENDENTE_CALIBRACAO;
+    return ESP_OK;
+}
+
+void sensor_table_clear_calibration(sensor_t *sensor) {
+    sensor->curva.n = 0;
+    rebuild_lut(sensor);
+    sensor->pendente |= SENSOR_PENDENTE_CALIBRACAO;
+}
+
+size_t sensor_table_commit(nvs_handle_t handle) {
+    size_t gravados = 0;
+    for (size_t i = 0; i < s_n_sensores; i++) {
+        sensor_t *sensor = &s_sensores[i];
+        char chave[16];
+        esp_err_t err = ESP_OK;
+
+        if (sensor->pendente & SENSOR_PENDENTE_THRESHOLD) {
+            nvs_key_threshold(i, chave, sizeof(chave));
+            err = nvs_set_i32(handle, chave, sensor->threshold);
+            if (err == ESP_OK) {
+                sensor->pendente &= ~SENSOR_PENDENTE_THRESHOLD;
+                gravados++;
+            }
+        }
+        if (err == ESP_OK && (sensor->pendente & SENSOR_PENDENTE_HISTERESE)) {
+            snprintf(chave, sizeof(chave), "hist%u", (unsigned)i);
+            err = nvs_set_i32(handle, chave, sensor->histerese);
+            if (err == ESP_OK) {
+                sensor->pendente &= ~SENSOR_PENDENTE_HISTERESE;
+                gravados++;
+            }
+        }
+        if (err == ESP_OK && (sensor->pendente & SENSOR_PENDENTE_CALIBRACAO)) {
+            snprintf(chave, sizeof(chave), "cal%u", (unsigned)i);
+            if (sensor->curva.n == 0) {
+                err = nvs_erase_key(handle, chave);
+                if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;
+            } else {
+                err = nvs_set_blob(handle, chave, sensor->curva.pontos, sensor->curva.n * sizeof(sensor->curva.pontos[0]));
+            }
+            if (err == ESP_OK) {
+                sensor->pendente &= ~SENSOR_PENDENTE_CALIBRACAO;
+                gravados++;
+            }
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Erro (%s) gravando a configuração do sensor %u na NVS!", esp_err_to_name(err), (unsigned)i);
+        }
+    }
+    return gravados;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+// Tabela de sensores: cada vaso tem canal do ADC1, calibração, limite de alerta, LED e
+// sufixo de tópico próprios. O limite, a histerese e a curva de calibração de cada vaso são
+// salvos separadamente na NVS.
+// As alterações só marcam o vaso como pendente; a gravação é feita por sensor_table_commit(),
+// para que vários comandos seguidos resultem em uma única escrita na flash.
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "nvs.h"
+#include "board.h"
+#include "sensor_adc.h"
+#include "sensor_calibration.h"
+
+#define SENSOR_TABLE_MAX    SENSOR_ADC_MAX_CANAIS
+#define SENSOR_TOPICO_MAX   64
+
+// O que falta gravar na NVS de cada vaso.
+#define SENSOR_PENDENTE_THRESHOLD   0x01
+#define SENSOR_PENDENTE_HISTERESE   0x02
+#define SENSOR_PENDENTE_CALIBRACAO  0x04
+
+typedef struct {
+    const char *nome;      // Aparece nas mensagens e no relatório de leituras.
+    const char *sufixo;    // Acrescentado ao tópico base; "" mantém os tópicos originais.
+    board_channel_t canal;
+    board_led_t led;       // BOARD_SEM_LED se o vaso não tiver LED.
+    int min_molhado;       // Calibração padrão: leitura com o solo encharcado.
+    int max_seco;          // Calibração padrão: leitura com o solo seco.
+    int threshold;         // Limite de alerta padrão, em %.
+    int histerese;         // Quanto a umidade precisa subir acima do limite para sair do estado seco, em %.
+} sensor_config_t;
+
+typedef struct {
+    const sensor_config_t *config;
+    int threshold;                   // Limite atual (pode vir da NVS).
+    int histerese;                   // Histerese atual (pode vir da NVS).
+    char topico[SENSOR_TOPICO_MAX];  // Tópico base + sufixo.
+    calibration_curve_t curva;       // Pontos capturados; com menos de 2 vale a calibração padrão.
+    uint8_t *lut;                    // Porcentagem de cada leitura do ADC, montada a partir da curva.
+    uint8_t pendente;                // SENSOR_PENDENTE_* ainda não gravados na NVS.
+} sensor_t;
+
+esp_err_t sensor_table_init(const sensor_config_t *configs, size_t n, const char *topico_base);
+
+size_t sensor_table_count(void);
+
+sensor_t *sensor_table_get(size_t indice);
+
+size_t sensor_table_index(const sensor_t *sensor);
+
+// Monta "<tópico do sensor><sufixo>" em saida.
+void sensor_table_topic(const sensor_t *sensor, const char *sufixo, char *saida, size_t len);
+
+// Monta " (nome)" para identificar o vaso nas mensagens; vazio quando o vaso não tem nome.
+void sensor_table_label(const sensor_t *sensor, char *saida, size_t len);
+
+// Procura o sensor cujo tópico + sufixo é igual ao tópico recebido (que não termina em '\0').
+sensor_t *sensor_table_find_topic(const char *topico, size_t len, const char *sufixo);
+
+// Converte uma leitura do ADC em porcentagem de umidade consultando a tabela do vaso.
+static inline int sensor_table_percent(const sensor_t *sensor, uint16_t raw) {
+    return calibration_lookup(sensor->lut, raw);
+}
+
+// Carrega da NVS o limite, a histerese e a curva de calibração de cada sensor e monta as tabelas de conversão.
+void sensor_table_load(void);
+
+void sensor_table_set_threshold(sensor_t *sensor, int threshold);
+
+void sensor_table_set_hysteresis(sensor_t *sensor, int histerese);
+
+// Acrescenta um ponto de referência à curva do vaso e remonta a tabela.
+// Retorna ESP_ERR_INVALID_ARG se o ponto deixar a curva não monotônica ou se ela estiver cheia.
+esp_err_t sensor_table_add_calibration_point(sensor_t *sensor, uint16_t raw, uint8_t percent);
+
+// Descarta os pontos capturados e volta à calibração padrão da tabela.
+void sensor_table_clear_calibration(sensor_t *sensor);
+
+// Grava no handle aberto tudo que está pendente em todos os vasos (sem chamar nvs_commit).
+// Retorna quantos valores foram gravados.
+size_t sensor_table_commit(nvs_handle_t handle);
@@ -0,0 +1,204 @@
+#include "store_forward.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_partition.h"
+#include "esp_log.h"
+#include "reading_log.h"
+#include "clock_sync.h"
+#include "metrics.h"
+
+static const char *TAG = "STORE_FORWARD";
+
+#define SF_CONECTADO_BIT BIT0
+#define SF_PENDENTE_BIT  BIT1
+
+static const esp_partition_t *s_particao;
+static reading_log_t s_log;
+static SemaphoreHandle_t s_log_mutex;
+static EventGroupHandle_t s_eventos;
+static TaskHandle_t s_replay_task;
+static esp_mqtt_client_handle_t s_cliente;
+static const char *s_topico;
+// PUBACK do quadro de reenvio. Outras publicações do cliente também geram MQTT_EVENT_PUBLISHED, então
+// a tarefa só é acordada pelo msg_id do próprio quadro. O PUBACK pode chegar antes de
+// esp_mqtt_client_publish retornar o msg_id: nessa janela os ids confirmados ficam guardados.
+#define SF_ACKS_ANTECIPADOS 4
+static portMUX_TYPE s_ack_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_msg_id_pendente = -1;
+static bool s_publicando;
+static bool s_confirmado;
+static int s_acks_antecipados[SF_ACKS_ANTECIPADOS];
+static size_t s_n_acks_antecipados;
+
+static bool particao_read(void *ctx, uint32_t offset, void *buf, size_t len) {
+    return esp_partition_read(ctx, offset, buf, len) == ESP_OK;
+}
+
+static bool particao_write(void *ctx, uint32_t offset, const void *buf, size_t len) {
+    return esp_partition_write(ctx, offset, buf, len) == ESP_OK;
+}
+
+static bool particao_erase(void *ctx, uint32_t offset) {
+    return esp_partition_erase_range(ctx, offset, READING_LOG_SECTOR_SIZE) == ESP_OK;
+}
+
+// Reenvia o backlog enquanto houver conexão, um quadro por vez, só consumindo após o PUBACK.
+static void replay_task(void *arg) {
+    static telemetry_batch_t lote;
+    static uint8_t quadro[TELEMETRY_FRAME_MAX_BYTES];
+
+    while (1) {
+        xEventGroupWaitBits(s_eventos, SF_CONECTADO_BIT | SF_PENDENTE_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+
+        xSemaphoreTake(s_log_mutex, portMAX_DELAY);
+        lote.n = reading_log_peek(&s_log, lote.leituras, STORE_FORWARD_LOTE);
+        if (lote.n == 0) xEventGroupClearBits(s_eventos, SF_PENDENTE_BIT);
+        xSemaphoreGive(s_log_mutex);
+        if (lote.n == 0) continue;
+        // Horários gravados antes do SNTP só são corrigidos depois que ele responde; espera um pouco.
+        bool corrigido = true;
+        for (size_t i = 0; i < lote.n; i++) {
+            corrigido &= clock_sync_fix(&lote.leituras[i]);
+        }
+        if (!corrigido && clock_sync_pending()) {
+            vTaskDelay(pdMS_TO_TICKS(STORE_FORWARD_INTERVALO_MS));
+            continue;
+        }
+        // O quadro só leva o seq e o horário da primeira leitura: corta o lote no primeiro buraco de
+        // sequência (leituras publicadas ao vivo entre dois períodos sem conexão, ou um reinício) e
+        // onde o horário volta ou salta mais que o delta de 16 bits (boot que nunca sincronizou).
+        for (size_t i = 1; i < lote.n; i++) {
+            if (lote.leituras[i].seq != lote.leituras[0].seq + i ||
+                lote.leituras[i].timestamp - lote.leituras[i - 1].timestamp > 0xFFFF) {
+                lote.n = i;
+                break;
+            }
+        }
+
+        size_t tamanho = telemetry_encode(&lote, quadro, sizeof(quadro));
+        ulTaskNotifyTake(pdTRUE, 0); // Descarta um aviso atrasado de um quadro anterior.
+        portENTER_CRITICAL(&s_ack_lock);
+        s_publicando = true;
+        s_confirmado = false;
+        s_n_acks_antecipados = 0;
+        portEXIT_CRITICAL(&s_ack_lock);
+
+        int64_t publicacao_us = metrics_start();
+        int msg_id = esp_mqtt_client_publish(s_cliente, s_topico, (const char *)quadro, tamanho, 1, 0);
+        metrics_record_since(METRIC_MQTT_PUBLISH, publicacao_us);
+
+        portENTER_CRITICAL(&s_ack_lock);
+        s_publicando = false;
+        s_msg_id_pendente = msg_id;
+        for (size_t i = 0; i < s_n_acks_antecipados; i++) {
+            if (msg_id >= 0 && s_acks_antecipados[i] == msg_id) s_confirmado = true;
+        }
+        bool confirmado = s_confirmado;
+        portEXIT_CRITICAL(&s_ack_lock);
+
+        TickType_t inicio = xTaskGetTickCount();
+        while (msg_id >= 0 && !confirmado) {
+            TickType_t decorrido = xTaskGetTickCount() - inicio;
+            if (decorrido >= pdMS_TO_TICKS(STORE_FORWARD_PUBACK_MS)) break;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(STORE_FORWARD_PUBACK_MS) - decorrido);
+            portENTER_CRITICAL(&s_ack_lock);
+            confirmado = s_confirmado;
+            portEXIT_CRITICAL(&s_ack_lock);
+        }
+        portENTER_CRITICAL(&s_ack_lock);
+        s_msg_id_pendente = -1;
+        portEXIT_CRITICAL(&s_ack_lock);
+        if (!confirmado) {
+            // Sem PUBACK o lote continua no log; no pior caso o broker recebe leituras repetidas (mesmo seq).
+            ESP_LOGW(TAG, "Quadro de reenvio não confirmado. Tentando novamente mais tarde.");
+            vTaskDelay(pdMS_TO_TICKS(STORE_FORWARD_INTERVALO_MS));
+            continue;
+        }
+
+        xSemaphoreTake(s_log_mutex, portMAX_DELAY);
+        reading_log_consume(&s_log, lote.n);
+        uint32_t restantes = reading_log_pending(&s_log);
+        xSemaphoreGive(s_log_mutex);
+        ESP_LOGI(TAG, "Reenviadas %u leituras do backlog (%u restantes).", (unsigned)lote.n, (unsigned)restantes);
+
+        vTaskDelay(pdMS_TO_TICKS(STORE_FORWARD_INTERVALO_MS));
+    }
+}
+
+esp_err_t store_forward_init(esp_mqtt_client_handle_t cliente, const char *topico) {
+    s_cliente = cliente;
+    s_topico = topico;
+    s_particao = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, STORE_FORWARD_PARTITION);
+    if (s_particao == NULL) {
+        ESP_LOGE(TAG, "Partição '%s' não encontrada!", STORE_FORWARD_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    reading_log_flash_t flash = {
+        .read = particao_read,
+        .write = particao_write,
+        .erase_sector = particao_erase,
+        .ctx = (void *)s_particao,
+        .size = s_particao->size,
+    };
+    if (!reading_log_open(&s_log, &flash)) {
+        ESP_LOGE(TAG, "Erro abrindo o log de leituras!");
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "Log de leituras aberto: %u pendentes.", (unsigned)reading_log_pending(&s_log));
+
+    s_log_mutex = xSemaphoreCreateMutex();
+    s_eventos = xEventGroupCreate();
+    if (s_log_mutex == NULL || s_eventos == NULL) return ESP_ERR_NO_MEM;
+    if (reading_log_pending(&s_log) > 0) xEventGroupSetBits(s_eventos, SF_PENDENTE_BIT);
+    if (xTaskCreate(replay_task, "store_forward", 3072, NULL, 4, &s_replay_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t store_forward_append(const telemetry_reading_t *leitura) {
+    xSemaphoreTake(s_log_mutex, portMAX_DELAY);
+    uint32_t descartados = s_log.descartados;
+    bool ok = reading_log_append(&s_log, leitura);
+    if (s_log.descartados != descartados) {
+        ESP_LOGW(TAG, "Log cheio: %u leituras antigas descartadas.", (unsigned)(s_log.descartados - descartados));
+    }
+    xSemaphoreGive(s_log_mutex);
+    if (!ok) {
+        ESP_LOGE(TAG, "Falha ao gravar leitura no log!");
+        return ESP_FAIL;
+    }
+    xEventGroupSetBits(s_eventos, SF_PENDENTE_BIT);
+    return ESP_OK;
+}
+
+uint32_t store_forward_pending(void) {
+    xSemaphoreTake(s_log_mutex, portMAX_DELAY);
+    uint32_t pendentes = reading_log_pending(&s_log);
+    xSemaphoreGive(s_log_mutex);
+    return pendentes;
+}
+
+void store_forward_on_connected(void) {
+    xEventGroupSetBits(s_eventos, SF_CONECTADO_BIT);
+}
+
+void store_forward_on_disconnected(void) {
+    xEventGroupClearBits(s_eventos, SF_CONECTADO_BIT);
+}
+
+void store_forward_on_published(int msg_id) {
+    bool acordar = false;
+    portENTER_CRITICAL(&s_ack_lock);
+    if (msg_id >= 0 && msg_id == s_msg_id_pendente) {
+        s_confirmado = true;
+        acordar = true;
+    } else if (s_publicando && s_n_acks_antecipados < SF_ACKS_ANTECIPADOS) {
+        s_acks_antecipados[s_n_acks_antecipados++] = msg_id;
+    }
+    portEXIT_CRITICAL(&s_ack_lock);
+    if (acordar && s_replay_task) xTaskNotifyGive(s_replay_task);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Guarda em flash as leituras feitas enquanto o broker está inacessível e as reenvia,
+// em lotes com intervalo mínimo, quando a conexão MQTT volta.
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "mqtt_client.h"
+#include "telemetry.h"
+
+#define STORE_FORWARD_PARTITION       "fila"  // Partição de dados definida em partitions.csv.
+#define STORE_FORWARD_LOTE            TELEMETRY_MAX_READINGS // Leituras por quadro reenviado.
+#define STORE_FORWARD_INTERVALO_MS    1000    // Pausa entre quadros para não inundar o broker.
+#define STORE_FORWARD_PUBACK_MS       10000   // Tempo máximo esperando a confirmação de um quadro.
+
+// Abre o log na partição e cria a tarefa de reenvio, que publica quadros binários no tópico informado.
+esp_err_t store_forward_init(esp_mqtt_client_handle_t cliente, const char *topico);
+
+esp_err_t store_forward_append(const telemetry_reading_t *leitura);
+
+uint32_t store_forward_pending(void);
+
+// Devem ser chamadas pelo handler de eventos MQTT.
+void store_forward_on_connected(void);
+void store_forward_on_disconnected(void);
+void store_forward_on_published(int msg_id);
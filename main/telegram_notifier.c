@@ -0,0 +1,214 @@
+#include "telegram_notifier.h"
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_http_client.h"
+#include "sdkconfig.h"
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+#include "esp_crt_bundle.h"
+#endif
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "metrics.h"
+
+static const char *TAG = "TELEGRAM";
+
+typedef struct {
+    char texto[TELEGRAM_MENSAGEM_MAX];
+    int64_t enfileirada_us;
+} telegram_msg_t;
+
+static telegram_notifier_config_t s_config;
+static QueueHandle_t s_fila;
+static telegram_stats_t s_stats;
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static esp_http_client_handle_t s_http;
+static char s_url[192];
+
+// Texto agrupado aguardando envio e a mensagem que não coube nele.
+static char s_texto[TELEGRAM_TEXTO_MAX];
+static size_t s_texto_len;
+static int64_t s_texto_desde_us;
+static telegram_msg_t s_sobra;
+static bool s_tem_sobra;
+
+// Converte uma string para o formato URL seguro, codificando caracteres especiais.
+static void url_encode(const char *src, char *dst, size_t dst_len) {
+    size_t i = 0;
+    while (*src && i + 4 < dst_len) {
+        if (isalnum((unsigned char)*src) || *src == '-' || *src == '_' || *src == '.' || *src == '~') {
+            dst[i++] = *src;
+        } else {
+            i += snprintf(&dst[i], 4, "%%%02X", (unsigned char)*src);
+        }
+        src++;
+    }
+    dst[i] = '\0';
+}
+
+// Junta a mensagem ao texto pendente. Retorna false se não couber.
+static bool agrupar(const telegram_msg_t *msg) {
+    size_t len = strlen(msg->texto);
+    size_t separador = s_texto_len > 0 ? 2 : 0;
+    if (s_texto_len + separador + len >= sizeof(s_texto)) return false;
+    if (separador) {
+        memcpy(&s_texto[s_texto_len], "\n\n", 2);
+        s_texto_len += 2;
+        portENTER_CRITICAL(&s_stats_lock);
+        s_stats.agrupadas++;
+        portEXIT_CRITICAL(&s_stats_lock);
+    } else {
+        s_texto_desde_us = msg->enfileirada_us;
+    }
+    memcpy(&s_texto[s_texto_len], msg->texto, len + 1);
+    s_texto_len += len;
+    return true;
+}
+
+static void receber(const telegram_msg_t *msg) {
+    if (!agrupar(msg)) {
+        s_sobra = *msg;
+        s_tem_sobra = true;
+    }
+}
+
+// Faz o POST reaproveitando a conexão TLS aberta na requisição anterior.
+static esp_err_t enviar(const char *texto) {
+    static char corpo[TELEGRAM_TEXTO_MAX * 3 + 64];
+    int n = snprintf(corpo, sizeof(corpo), "chat_id=%s&text=", s_config.chat_id);
+    url_encode(texto, &corpo[n], sizeof(corpo) - n);
+
+    esp_http_client_set_post_field(s_http, corpo, strlen(corpo));
+    int64_t inicio_us = metrics_start();
+    esp_err_t err = esp_http_client_perform(s_http);
+    metrics_record_since(METRIC_TELEGRAM_SEND, inicio_us);
+    if (err == ESP_OK && esp_http_client_get_status_code(s_http) != 200) {
+        ESP_LOGE(TAG, "Telegram respondeu com status %d.", esp_http_client_get_status_code(s_http));
+        err = ESP_FAIL;
+    }
+    if (err != ESP_OK) {
+        // Descarta a conexão para que a próxima tentativa comece do zero.
+        esp_http_client_close(s_http);
+    }
+    return err;
+}
+
+static void telegram_task(void *arg) {
+    uint32_t backoff_ms = TELEGRAM_BACKOFF_MIN_MS;
+    telegram_msg_t msg;
+
+    while (1) {
+        if (s_texto_len == 0) {
+            if (s_tem_sobra) {
+                agrupar(&s_sobra);
+                s_tem_sobra = false;
+            } else {
+                xQueueReceive(s_fila, &msg, portMAX_DELAY);
+                receber(&msg);
+            }
+        }
+
+        // Janela de agrupamento: alertas que chegam logo em seguida vão na mesma mensagem.
+        TickType_t inicio = xTaskGetTickCount();
+        while (!s_tem_sobra && xTaskGetTickCount() - inicio < pdMS_TO_TICKS(TELEGRAM_AGRUPAR_MS)) {
+            TickType_t restante = pdMS_TO_TICKS(TELEGRAM_AGRUPAR_MS) - (xTaskGetTickCount() - inicio);
+            if (xQueueReceive(s_fila, &msg, restante) != pdTRUE) break;
+            receber(&msg);
+        }
+
+        esp_err_t err = enviar(s_texto);
+        uint32_t latencia_ms = (uint32_t)((esp_timer_get_time() - s_texto_desde_us) / 1000);
+        portENTER_CRITICAL(&s_stats_lock);
+        if (err == ESP_OK) {
+            s_stats.enviadas++;
+        } else {
+            s_stats.falhas++;
+        }
+        portEXIT_CRITICAL(&s_stats_lock);
+        if (err == ESP_OK) {
+            // Com o Telegram fora por mais de ~71 min a latência não cabe em µs de 32 bits: satura.
+            int64_t fila_us = esp_timer_get_time() - s_texto_desde_us;
+            metrics_record(METRIC_TELEGRAM_QUEUE, fila_us > UINT32_MAX ? UINT32_MAX : (uint32_t)fila_us);
+        }
+
+        if (err == ESP_OK) {
+            ESP_LOGI(TAG, "Mensagem enviada para o Telegram com sucesso! (%u ms desde a fila)", (unsigned)latencia_ms);
+            s_texto_len = 0;
+            backoff_ms = TELEGRAM_BACKOFF_MIN_MS;
+        } else {
+            // O texto continua pendente; o que chegar durante a espera será agrupado a ele.
+            ESP_LOGE(TAG, "Erro ao enviar mensagem para o Telegram: %s. Nova tentativa em %u ms.", esp_err_to_name(err), (unsigned)backoff_ms);
+            vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+            backoff_ms = backoff_ms * 2 > TELEGRAM_BACKOFF_MAX_MS ? TELEGRAM_BACKOFF_MAX_MS : backoff_ms * 2;
+        }
+    }
+}
+
+esp_err_t telegram_notifier_init(const telegram_notifier_config_t *config) {
+    if (config->token == NULL || config->token[0] == '\0' || config->chat_id == NULL || config->chat_id[0] == '\0') {
+        ESP_LOGW(TAG, "Token/Chat ID do Telegram não configurado. Notificações desativadas.");
+        return ESP_OK;
+    }
+    s_config = *config;
+    snprintf(s_url, sizeof(s_url), "%s/bot%s/sendMessage", config->api_url, config->token);
+
+    esp_http_client_config_t http_cfg = {
+        .url = s_url,
+        .method = HTTP_METHOD_POST,
+        .keep_alive_enable = true,
+        .timeout_ms = 10000,
+    };
+    if (config->cert_pem) {
+        http_cfg.cert_pem = config->cert_pem;
+    } else {
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+        http_cfg.crt_bundle_attach = esp_crt_bundle_attach;
+#else
+        // Sem o bundle de CAs no menuconfig só é possível usar cert_pem.
+        ESP_LOGE(TAG, "Bundle de CAs desativado no menuconfig; informe cert_pem.");
+        return ESP_ERR_NOT_SUPPORTED;
+#endif
+    }
+    s_http = esp_http_client_init(&http_cfg);
+    if (s_http == NULL) return ESP_FAIL;
+    esp_http_client_set_header(s_http, "Content-Type", "application/x-www-form-urlencoded");
+
+    s_fila = xQueueCreate(TELEGRAM_FILA_TAMANHO, sizeof(telegram_msg_t));
+    if (s_fila == NULL) return ESP_ERR_NO_MEM;
+    if (xTaskCreate(telegram_task, "telegram", 6144, NULL, 3, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+bool telegram_notify(const char *mensagem) {
+    if (s_fila == NULL) return false;
+
+    telegram_msg_t msg;
+    snprintf(msg.texto, sizeof(msg.texto), "%s", mensagem);
+    msg.enfileirada_us = esp_timer_get_time();
+    bool ok = xQueueSend(s_fila, &msg, 0) == pdTRUE;
+
+    uint32_t na_fila = uxQueueMessagesWaiting(s_fila);
+    portENTER_CRITICAL(&s_stats_lock);
+    if (!ok) s_stats.descartadas++;
+    if (na_fila > s_stats.fila_max) s_stats.fila_max = na_fila;
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    if (!ok) ESP_LOGW(TAG, "Fila do Telegram cheia. Mensagem descartada.");
+    return ok;
+}
+
+void telegram_notifier_get_stats(telegram_stats_t *stats) {
+    portENTER_CRITICAL(&s_stats_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_stats_lock);
+    stats->fila_atual = s_fila ? uxQueueMessagesWaiting(s_fila) : 0;
+}
+
+bool telegram_notifier_idle(void) {
+    return s_fila == NULL || (s_texto_len == 0 && !s_tem_sobra && uxQueueMessagesWaiting(s_fila) == 0);
+}
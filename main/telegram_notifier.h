@@ -0,0 +1,45 @@
+#pragma once
+
+// Envio assíncrono de notificações para o Telegram.
+// Quem chama só coloca a mensagem numa fila limitada; uma tarefa dedicada mantém a conexão
+// TLS aberta, agrupa rajadas de alertas em uma única mensagem e espera mais a cada falha.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define TELEGRAM_MENSAGEM_MAX     256    // Tamanho máximo de cada mensagem enfileirada.
+#define TELEGRAM_TEXTO_MAX        768    // Tamanho máximo do texto agrupado em uma requisição.
+#define TELEGRAM_FILA_TAMANHO     8      // Mensagens aguardando envio.
+#define TELEGRAM_AGRUPAR_MS       2000   // Janela para juntar alertas que chegam em sequência.
+#define TELEGRAM_BACKOFF_MIN_MS   1000
+#define TELEGRAM_BACKOFF_MAX_MS   60000
+
+typedef struct {
+    const char *token;
+    const char *chat_id;
+    const char *api_url;   // "https://api.telegram.org" ou um servidor HTTPS local para testes.
+    const char *cert_pem;  // Certificado do servidor local; NULL usa o bundle de CAs oficial.
+} telegram_notifier_config_t;
+
+typedef struct {
+    uint32_t enviadas;        // Requisições HTTP bem-sucedidas.
+    uint32_t agrupadas;       // Mensagens que entraram em uma requisição junto com outras.
+    uint32_t falhas;
+    uint32_t descartadas;     // Mensagens perdidas porque a fila estava cheia.
+    uint32_t fila_atual;
+    uint32_t fila_max;
+} telegram_stats_t;
+// A latência da fila até a confirmação do Telegram fica no histograma METRIC_TELEGRAM_QUEUE.
+
+// Cria a fila e a tarefa de envio. Sem token/chat ID o notificador fica desativado.
+esp_err_t telegram_notifier_init(const telegram_notifier_config_t *config);
+
+// Enfileira uma mensagem sem bloquear. Retorna false se a fila estiver cheia ou o notificador desativado.
+bool telegram_notify(const char *mensagem);
+
+// Contadores publicados junto com as métricas (campo tg_msg de /metrics).
+void telegram_notifier_get_stats(telegram_stats_t *stats);
+
+// True quando não há nada na fila nem aguardando envio (usado antes de dormir).
+bool telegram_notifier_idle(void);
@@ -0,0 +1,81 @@
+#include "telemetry.h"
+
+#define TELEMETRY_FLAG_SECO     0x8000
+#define TELEMETRY_SENSOR_SHIFT  12
+#define TELEMETRY_SENSOR_MASK   0x7
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, v & 0xFFFF);
+    put_u16(p + 2, v >> 16);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+void telemetry_batch_reset(telemetry_batch_t *lote) {
+    lote->n = 0;
+}
+
+bool telemetry_batch_add(telemetry_batch_t *lote, const telemetry_reading_t *leitura) {
+    if (lote->n >= TELEMETRY_MAX_READINGS) return false;
+    lote->leituras[lote->n++] = *leitura;
+    return true;
+}
+
+size_t telemetry_encode(const telemetry_batch_t *lote, uint8_t *buf, size_t buf_len) {
+    size_t tamanho = TELEMETRY_HEADER_BYTES + lote->n * TELEMETRY_READING_BYTES;
+    if (lote->n == 0 || tamanho > buf_len) return 0;
+
+    const telemetry_reading_t *primeira = &lote->leituras[0];
+    buf[0] = TELEMETRY_FRAME_VERSION;
+    buf[1] = (uint8_t)lote->n;
+    put_u32(&buf[2], primeira->seq);
+    put_u32(&buf[6], primeira->timestamp);
+
+    uint8_t *p = buf + TELEMETRY_HEADER_BYTES;
+    uint32_t ts_anterior = primeira->timestamp;
+    for (size_t i = 0; i < lote->n; i++) {
+        const telemetry_reading_t *l = &lote->leituras[i];
+        uint32_t delta = l->timestamp - ts_anterior;
+        put_u16(p, (l->raw & 0x0FFF) | ((l->sensor & TELEMETRY_SENSOR_MASK) << TELEMETRY_SENSOR_SHIFT) |
+                   (l->seco ? TELEMETRY_FLAG_SECO : 0));
+        p[2] = l->percent;
+        put_u16(p + 3, delta > 0xFFFF ? 0xFFFF : (uint16_t)delta);
+        ts_anterior = l->timestamp;
+        p += TELEMETRY_READING_BYTES;
+    }
+    return tamanho;
+}
+
+bool telemetry_decode(const uint8_t *buf, size_t len, telemetry_batch_t *lote) {
+    if (len < TELEMETRY_HEADER_BYTES || buf[0] != TELEMETRY_FRAME_VERSION) return false;
+    size_t n = buf[1];
+    if (n > TELEMETRY_MAX_READINGS || len < TELEMETRY_HEADER_BYTES + n * TELEMETRY_READING_BYTES) return false;
+
+    uint32_t seq = get_u32(&buf[2]);
+    uint32_t ts = get_u32(&buf[6]);
+    const uint8_t *p = buf + TELEMETRY_HEADER_BYTES;
+    for (size_t i = 0; i < n; i++) {
+        uint16_t raw_flags = get_u16(p);
+        ts += get_u16(p + 3);
+        lote->leituras[i].timestamp = ts;
+        lote->leituras[i].seq = seq + (uint32_t)i;
+        lote->leituras[i].raw = raw_flags & 0x0FFF;
+        lote->leituras[i].sensor = (raw_flags >> TELEMETRY_SENSOR_SHIFT) & TELEMETRY_SENSOR_MASK;
+        lote->leituras[i].seco = (raw_flags & TELEMETRY_FLAG_SECO) != 0;
+        lote->leituras[i].percent = p[2];
+        p += TELEMETRY_READING_BYTES;
+    }
+    lote->n = n;
+    return true;
+}
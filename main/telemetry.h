@@ -0,0 +1,48 @@
+#pragma once
+
+// Quadro binário compacto que agrupa várias leituras em uma única publicação MQTT.
+// Este módulo não depende do ESP-IDF: o mesmo código codifica no dispositivo e decodifica no computador.
+//
+// Formato (inteiros little-endian):
+//   cabeçalho: versão (u8) | quantidade (u8) | seq da 1ª leitura (u32) | timestamp da 1ª leitura em s (u32)
+//   leitura:   raw (bits 0-11) + índice do sensor (bits 12-14) + estado seco (bit 15) (u16)
+//              | porcentagem (u8) | segundos desde a leitura anterior (u16)
+// O número de sequência das leituras seguintes é implícito (seq da 1ª + índice).
+// Os horários são Unix depois que o relógio do dispositivo é acertado pelo SNTP (ver clock_sync.h);
+// abaixo de 1700000000 são segundos desde a energização de um boot que nunca sincronizou.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define TELEMETRY_FRAME_VERSION   1
+#define TELEMETRY_MAX_READINGS    32
+#define TELEMETRY_HEADER_BYTES    10
+#define TELEMETRY_READING_BYTES   5
+#define TELEMETRY_FRAME_MAX_BYTES (TELEMETRY_HEADER_BYTES + TELEMETRY_MAX_READINGS * TELEMETRY_READING_BYTES)
+
+typedef struct {
+    uint32_t timestamp; // Segundos do relógio do sistema (no dispositivo, desde a energização até o SNTP).
+    uint32_t seq;
+    uint16_t raw;
+    uint8_t percent;
+    uint8_t sensor;     // Índice na tabela de sensores (0 a 7).
+    bool seco;
+    uint8_t boot;       // Boot em que a leitura foi feita; não vai no quadro.
+} telemetry_reading_t;
+
+typedef struct {
+    telemetry_reading_t leituras[TELEMETRY_MAX_READINGS];
+    size_t n;
+} telemetry_batch_t;
+
+void telemetry_batch_reset(telemetry_batch_t *lote);
+
+// Adiciona uma leitura ao lote. Retorna false se o lote já está cheio.
+bool telemetry_batch_add(telemetry_batch_t *lote, const telemetry_reading_t *leitura);
+
+// Codifica o lote em buf. Retorna o tamanho do quadro ou 0 se buf for pequeno demais.
+size_t telemetry_encode(const telemetry_batch_t *lote, uint8_t *buf, size_t buf_len);
+
+// Decodifica um quadro. Retorna false se o quadro estiver truncado ou for de outra versão.
+bool telemetry_decode(const uint8_t *buf, size_t len, telemetry_batch_t *lote);
@@ -0,0 +1,17 @@
+# SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: CC0-1.0
+from typing import Callable
+
+import pytest
+from pytest_embedded_idf.dut import IdfDut
+
+
+@pytest.mark.esp32
+@pytest.mark.generic
+def test_soloscan(
+    dut: IdfDut, log_minimum_free_heap_size: Callable[..., None]
+) -> None:
+    dut.expect('[APP] Startup..')
+    dut.expect('Aguardando a estabilização do sensor')
+    log_minimum_free_heap_size()
+
@@ -0,0 +1,228 @@
+// Replay de traços de umidade comparando o loop fixo com a amostragem adaptativa de
+// main/adaptive_sampling.c: leituras e publicações por dia e tempo até detectar cada rega.
+//
+// Compilar e usar (no computador):
+//   gcc -O2 -I main tools/amostragem_replay.c main/adaptive_sampling.c -o amostragem_replay
+//   ./amostragem_replay traco.csv          # CSV com colunas timestamp e umidade (ex.: /historico?nivel=bruto)
+//   ./amostragem_replay --sintetico 30     # traço sintético de 30 dias (secagem lenta e regas)
+//
+// Para gravar um traço, configure intervalo=5 no tópico /config e baixe o nível bruto do
+// histórico a cada 20 minutos (a janela bruta guarda 240 leituras).
+// Os parâmetros abaixo espelham as configurações de main/main.c.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "adaptive_sampling.h"
+
+#define INTERVALO_FIXO_S    30
+#define THRESHOLD           35
+#define HISTERESE           3
+#define ADC_PERIODO_S       1   // Varredura contínua usada para acordar antes do intervalo.
+
+static const adaptive_config_t AMOSTRAGEM = {
+    .intervalo_min_ms = 5000,
+    .intervalo_max_ms = 300000,
+    .derivada_rapida = 120,
+    .derivada_estavel = 10,
+    .banda_morta = 2,
+    .heartbeat_s = 1800,
+};
+
+typedef struct {
+    uint32_t *ts;
+    uint8_t *percent;
+    size_t n;
+    size_t cap;
+} traco_t;
+
+typedef struct {
+    const char *nome;
+    unsigned long leituras;
+    unsigned long publicacoes;
+    uint32_t *deteccoes;
+    size_t n_deteccoes;
+} resultado_t;
+
+static void acrescentar(traco_t *t, uint32_t ts, int percent) {
+    if (t->n == t->cap) {
+        t->cap = t->cap ? t->cap * 2 : 4096;
+        t->ts = realloc(t->ts, t->cap * sizeof(*t->ts));
+        t->percent = realloc(t->percent, t->cap);
+        if (t->ts == NULL || t->percent == NULL) {
+            fprintf(stderr, "sem memória\n");
+            exit(1);
+        }
+    }
+    t->ts[t->n] = ts;
+    t->percent[t->n] = (uint8_t)(percent < 0 ? 0 : percent > 100 ? 100 : percent);
+    t->n++;
+}
+
+// Lê um CSV com cabeçalho; usa as colunas "timestamp" (ou "inicio") e "umidade" (ou "media").
+static int ler_csv(const char *caminho, traco_t *t) {
+    FILE *f = fopen(caminho, "r");
+    if (f == NULL) {
+        perror(caminho);
+        return -1;
+    }
+    char linha[256];
+    int col_ts = 0, col_pct = 1;
+    if (fgets(linha, sizeof(linha), f) != NULL) {
+        int col = 0;
+        for (char *campo = strtok(linha, ",\r\n"); campo != NULL; campo = strtok(NULL, ",\r\n"), col++) {
+            if (strcmp(campo, "timestamp") == 0 || strcmp(campo, "inicio") == 0) col_ts = col;
+            if (strcmp(campo, "umidade") == 0 || strcmp(campo, "media") == 0) col_pct = col;
+        }
+    }
+    while (fgets(linha, sizeof(linha), f) != NULL) {
+        long ts = -1, pct = -1;
+        int col = 0;
+        for (char *campo = strtok(linha, ",\r\n"); campo != NULL; campo = strtok(NULL, ",\r\n"), col++) {
+            if (col == col_ts) ts = strtol(campo, NULL, 10);
+            if (col == col_pct) pct = strtol(campo, NULL, 10);
+        }
+        if (ts < 0 || pct < 0 || (t->n > 0 && (uint32_t)ts <= t->ts[t->n - 1])) continue;
+        acrescentar(t, (uint32_t)ts, (int)pct);
+    }
+    fclose(f);
+    return t->n >= 2 ? 0 : -1;
+}
+
+// Secagem lenta (~0,4%/h com ruído de ±1%) e, algumas horas depois de passar do limite, uma
+// rega que sobe a umidade em cerca de 90 s. Uma amostra a cada 5 s.
+static void gerar_sintetico(traco_t *t, unsigned dias) {
+    uint32_t semente = 12345;
+    double umidade = 70.0;
+    double rega_em = -1, subida = 0;
+    for (uint32_t ts = 0; ts < dias * 86400u; ts += 5) {
+        semente = semente * 1103515245u + 12345u;
+        if (rega_em < 0 && umidade < THRESHOLD) {
+            rega_em = ts + 3600.0 * (1 + (semente >> 16) % 10); // Rega 1 a 10 h depois do alerta.
+        }
+        if (rega_em >= 0 && ts >= rega_em) {
+            subida = 45.0;
+            rega_em = -1;
+        }
+        if (subida > 0) {
+            double passo = subida < 2.5 ? subida : 2.5;
+            umidade += passo;
+            subida -= passo;
+        } else {
+            umidade -= 0.4 / 720.0;
+        }
+        int ruido = (int)((semente >> 24) % 16 == 0) - (int)((semente >> 24) % 16 == 1);
+        acrescentar(t, ts, (int)(umidade + 0.5) + ruido);
+    }
+}
+
+// Valor do traço no instante ts (a última amostra até ts).
+static uint8_t valor_em(const traco_t *t, size_t *cursor, uint32_t ts) {
+    while (*cursor + 1 < t->n && t->ts[*cursor + 1] <= ts) (*cursor)++;
+    return t->percent[*cursor];
+}
+
+// Mesma regra de monitor_cycle: seco abaixo do threshold, úmido de novo acima de threshold + histerese.
+// Retorna true quando a planta passa de seca para úmida (rega detectada).
+static bool avaliar(bool *seco, uint8_t percent) {
+    int limite = *seco ? THRESHOLD + HISTERESE : THRESHOLD;
+    bool agora_seco = percent < limite;
+    bool regou = *seco && !agora_seco;
+    *seco = agora_seco;
+    return regou;
+}
+
+static void registrar(resultado_t *r, uint32_t ts, size_t max) {
+    if (r->deteccoes == NULL) r->deteccoes = calloc(max + 1, sizeof(uint32_t));
+    if (r->n_deteccoes <= max) r->deteccoes[r->n_deteccoes++] = ts;
+}
+
+static void simular_fixo(const traco_t *t, resultado_t *r, size_t max) {
+    size_t cursor = 0;
+    bool seco = t->percent[0] < THRESHOLD;
+    for (uint32_t ts = t->ts[0]; ts <= t->ts[t->n - 1]; ts += INTERVALO_FIXO_S) {
+        r->leituras++;
+        r->publicacoes++;
+        if (avaliar(&seco, valor_em(t, &cursor, ts))) registrar(r, ts, max);
+    }
+}
+
+static void simular_adaptativo(const traco_t *t, resultado_t *r, size_t max, bool acordar_antes) {
+    adaptive_state_t estado = {0};
+    size_t cursor = 0;
+    bool seco = t->percent[0] < THRESHOLD;
+    uint32_t ts = t->ts[0];
+    while (ts <= t->ts[t->n - 1]) {
+        uint8_t percent = valor_em(t, &cursor, ts);
+        bool mudou = false;
+        if (r->leituras > 0) {
+            bool estava_seco = seco;
+            if (avaliar(&seco, percent)) registrar(r, ts, max);
+            mudou = seco != estava_seco;
+        }
+        r->leituras++;
+        uint32_t intervalo_s = adaptive_update(&estado, &AMOSTRAGEM, INTERVALO_FIXO_S * 1000, ts, percent) / 1000;
+        if (adaptive_should_report(&estado, &AMOSTRAGEM, ts, percent, mudou)) r->publicacoes++;
+
+        uint32_t proximo = ts + intervalo_s;
+        if (acordar_antes) {
+            size_t espiar = cursor;
+            for (uint32_t s = ts + ADC_PERIODO_S; s < proximo; s += ADC_PERIODO_S) {
+                if (adaptive_moved(&estado, &AMOSTRAGEM, valor_em(t, &espiar, s))) {
+                    proximo = s;
+                    break;
+                }
+            }
+        }
+        ts = proximo;
+    }
+}
+
+// Casa cada rega do traço com a primeira detecção que vem depois dela.
+static void imprimir(const resultado_t *r, const uint32_t *regas, size_t n_regas, double dias) {
+    double soma = 0;
+    uint32_t pior = 0;
+    size_t detectadas = 0, j = 0;
+    for (size_t i = 0; i < n_regas; i++) {
+        while (j < r->n_deteccoes && r->deteccoes[j] < regas[i]) j++;
+        if (j == r->n_deteccoes) break;
+        uint32_t atraso = r->deteccoes[j] - regas[i];
+        soma += atraso;
+        if (atraso > pior) pior = atraso;
+        detectadas++;
+        j++;
+    }
+    printf("%-28s %10.0f %14.0f %10.1f %8u %6zu/%zu\n", r->nome, r->leituras / dias, r->publicacoes / dias,
+           detectadas ? soma / detectadas : 0.0, (unsigned)pior, detectadas, n_regas);
+}
+
+int main(int argc, char **argv) {
+    traco_t traco = {0};
+    if (argc == 3 && strcmp(argv[1], "--sintetico") == 0) {
+        gerar_sintetico(&traco, (unsigned)atoi(argv[2]));
+    } else if (argc != 2 || ler_csv(argv[1], &traco) != 0) {
+        fprintf(stderr, "uso: %s <traço.csv> | --sintetico <dias>\n", argv[0]);
+        return 1;
+    }
+
+    // Regas de referência: avaliando todas as amostras do traço.
+    uint32_t *regas = calloc(traco.n, sizeof(uint32_t));
+    size_t n_regas = 0;
+    bool seco = traco.percent[0] < THRESHOLD;
+    for (size_t i = 0; i < traco.n; i++) {
+        if (avaliar(&seco, traco.percent[i])) regas[n_regas++] = traco.ts[i];
+    }
+    double dias = (traco.ts[traco.n - 1] - traco.ts[0]) / 86400.0;
+    printf("traço: %zu amostras, %.1f dias, %zu regas\n\n", traco.n, dias, n_regas);
+    printf("%-28s %10s %14s %10s %8s %8s\n", "modo", "leituras/d", "publicações/d", "atraso(s)", "pior(s)", "regas");
+
+    resultado_t fixo = { .nome = "fixo 30 s" };
+    resultado_t adaptativo = { .nome = "adaptativo" };
+    resultado_t adormecido = { .nome = "adaptativo (baixo consumo)" };
+    simular_fixo(&traco, &fixo, traco.n);
+    simular_adaptativo(&traco, &adaptativo, traco.n, true);
+    simular_adaptativo(&traco, &adormecido, traco.n, false);
+    imprimir(&fixo, regas, n_regas, dias);
+    imprimir(&adaptativo, regas, n_regas, dias);
+    imprimir(&adormecido, regas, n_regas, dias);
+    return 0;
+}
@@ -0,0 +1,164 @@
+// Testes e microbenchmark da curva de calibração (main/sensor_calibration.c) no computador,
+// comparando a tabela de consulta com a antiga map_to_percentage (regra de três entre
+// SENSOR_MIN_MOLHADO e SENSOR_MAX_SECO).
+//
+// Compilar e usar (no computador):
+//   gcc -O2 -I main tools/calibracao_teste.c main/sensor_calibration.c -lm -o calibracao_teste
+//   ./calibracao_teste
+//
+// A precisão é medida contra uma resposta sintética não linear do sensor, raw(p) = MIN +
+// (MAX - MIN) * (1 - p/100)^0,6, calibrada com 5 pontos (0, 20, 35, 50 e 100%). A faixa de 20% a
+// 50% é mostrada à parte porque é onde ficam os limiares dos tipos de planta.
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "sensor_calibration.h"
+
+#define SENSOR_MIN      1406    // SENSOR_MIN_MOLHADO de main/main.c
+#define SENSOR_MAX      3817    // SENSOR_MAX_SECO de main/main.c
+#define REPETICOES      20000
+
+#define CONFERIR(cond)                                               \
+    do {                                                             \
+        if (!(cond)) {                                               \
+            printf("FALHA (linha %d): %s\n", __LINE__, #cond);       \
+            return 1;                                                \
+        }                                                            \
+    } while (0)
+
+// Conversão usada antes da tabela, com a mesma aritmética inteira.
+static int map_to_percentage(int value) {
+    if (value < SENSOR_MIN) value = SENSOR_MIN;
+    if (value > SENSOR_MAX) value = SENSOR_MAX;
+    return 100 - ((value - SENSOR_MIN) * 100) / (SENSOR_MAX - SENSOR_MIN);
+}
+
+static double raw_do_sensor(double percent) {
+    return SENSOR_MIN + (SENSOR_MAX - SENSOR_MIN) * pow(1.0 - percent / 100.0, 0.6);
+}
+
+static uint8_t s_lut[CALIBRATION_LUT_SIZE];
+static uint8_t s_lut5[CALIBRATION_LUT_SIZE];
+static calibration_curve_t s_curva5;
+
+static int testes(void) {
+    // A curva padrão reproduz a conversão antiga em toda a faixa do ADC.
+    calibration_curve_t padrao;
+    calibration_curve_default(&padrao, SENSOR_MIN, SENSOR_MAX);
+    CONFERIR(calibration_build_lut(&padrao, s_lut));
+    int diferenca = 0;
+    for (int raw = 0; raw < CALIBRATION_LUT_SIZE; raw++) {
+        int d = abs(calibration_lookup(s_lut, (uint16_t)raw) - map_to_percentage(raw));
+        if (d > diferenca) diferenca = d;
+    }
+    CONFERIR(diferenca <= 1);
+    CONFERIR(s_lut[0] == 100 && s_lut[SENSOR_MIN] == 100 && s_lut[SENSOR_MAX] == 0 && s_lut[4095] == 0);
+
+    // Curva de 5 pontos, monotônica (mais água, leitura menor).
+    static const int pontos[] = {0, 20, 35, 50, 100};
+    s_curva5.n = 0;
+    for (size_t i = 0; i < sizeof(pontos) / sizeof(pontos[0]); i++) {
+        CONFERIR(calibration_curve_add(&s_curva5, (uint16_t)lround(raw_do_sensor(pontos[i])), (uint8_t)pontos[i]));
+    }
+    CONFERIR(s_curva5.n == 5 && calibration_curve_valid(&s_curva5));
+    CONFERIR(calibration_build_lut(&s_curva5, s_lut5));
+    for (uint8_t i = 0; i < s_curva5.n; i++) {
+        CONFERIR(s_lut5[s_curva5.pontos[i].raw] == s_curva5.pontos[i].percent);
+    }
+    for (int raw = 1; raw < CALIBRATION_LUT_SIZE; raw++) CONFERIR(s_lut5[raw] <= s_lut5[raw - 1]);
+
+    // Ponto fora de ordem é recusado sem alterar a curva; o mesmo raw substitui o ponto.
+    calibration_curve_t c = s_curva5;
+    CONFERIR(!calibration_curve_add(&c, (uint16_t)(lround(raw_do_sensor(35)) + 5), 60));
+    CONFERIR(c.n == 5);
+    CONFERIR(calibration_curve_add(&c, s_curva5.pontos[2].raw, 36));
+    CONFERIR(c.n == 5 && c.pontos[2].percent == 36);
+
+    // Um ponto só não forma curva: a tabela não é tocada.
+    calibration_curve_t um = {0};
+    CONFERIR(calibration_curve_add(&um, 2000, 50));
+    CONFERIR(!calibration_curve_valid(&um));
+    CONFERIR(!calibration_build_lut(&um, s_lut));
+    CONFERIR(s_lut[0] == 100 && s_lut[4095] == 0);
+
+    // Curva cheia recusa mais pontos.
+    calibration_curve_t cheia = {0};
+    for (int i = 0; i < CALIBRATION_MAX_POINTS; i++) {
+        CONFERIR(calibration_curve_add(&cheia, (uint16_t)(1000 + i * 100), (uint8_t)(100 - i * 10)));
+    }
+    CONFERIR(!calibration_curve_add(&cheia, 2500, 5));
+    printf("Testes da curva de calibração OK (curva padrão a no máximo %d%% da conversão antiga).\n", diferenca);
+    return 0;
+}
+
+static void precisao(void) {
+    double erro_antigo = 0, erro_lut = 0, erro_antigo_faixa = 0, erro_lut_faixa = 0;
+    for (double p = 0; p <= 100; p += 0.5) {
+        uint16_t raw = (uint16_t)lround(raw_do_sensor(p));
+        double antigo = fabs(map_to_percentage(raw) - p);
+        double lut = fabs(calibration_lookup(s_lut5, raw) - p);
+        if (antigo > erro_antigo) erro_antigo = antigo;
+        if (lut > erro_lut) erro_lut = lut;
+        if (p >= 20 && p <= 50) {
+            if (antigo > erro_antigo_faixa) erro_antigo_faixa = antigo;
+            if (lut > erro_lut_faixa) erro_lut_faixa = lut;
+        }
+    }
+    printf("Erro máximo: map_to_percentage %.1f%% (20-50%%: %.1f%%), tabela de 5 pontos %.1f%% (20-50%%: %.1f%%)\n",
+           erro_antigo, erro_antigo_faixa, erro_lut, erro_lut_faixa);
+}
+
+static double agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static uint64_t ciclos(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void benchmark(void) {
+    static uint16_t raws[1024];
+    uint32_t semente = 1;
+    for (size_t i = 0; i < 1024; i++) {
+        semente = semente * 1103515245u + 12345u;
+        raws[i] = (uint16_t)((semente >> 16) & 0xFFF);
+    }
+    volatile int sumidouro = 0;
+    const double conversoes = (double)REPETICOES * 1024;
+
+    double t0 = agora_ns();
+    uint64_t c0 = ciclos();
+    for (int r = 0; r < REPETICOES; r++) {
+        for (size_t i = 0; i < 1024; i++) sumidouro += map_to_percentage(raws[i]);
+    }
+    uint64_t c1 = ciclos();
+    double t1 = agora_ns();
+    for (int r = 0; r < REPETICOES; r++) {
+        for (size_t i = 0; i < 1024; i++) sumidouro += calibration_lookup(s_lut5, raws[i]);
+    }
+    uint64_t c2 = ciclos();
+    double t2 = agora_ns();
+    for (int r = 0; r < 1000; r++) calibration_build_lut(&s_curva5, s_lut5);
+    double t3 = agora_ns();
+
+    printf("Por conversão: map_to_percentage %.2f ns (%.2f ciclos), tabela %.2f ns (%.2f ciclos)\n",
+           (t1 - t0) / conversoes, (c1 - c0) / conversoes, (t2 - t1) / conversoes, (c2 - c1) / conversoes);
+    printf("Montagem da tabela de %d entradas: %.1f us\n", CALIBRATION_LUT_SIZE, (t3 - t2) / 1000 / 1e3);
+}
+
+int main(void) {
+    if (testes() != 0) return 1;
+    precisao();
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Verificação no computador do detector de estabilização do boot (sensor_settle_* em
+// main/sensor_filter.c), que substituiu a pausa fixa de 180 s antes da primeira leitura.
+//
+// Compilar e usar (no computador):
+//   gcc -O2 -I main tools/estabilizacao_check.c main/sensor_filter.c -lm -o estabilizacao_check
+//   ./estabilizacao_check
+//
+// O aquecimento do sensor é modelado como uma relaxação exponencial raw(t) = final +
+// (inicial - final) * e^(-t/tau), com ruído e picos nas amostras. Cada segundo passa pela mesma
+// cadeia da tarefa do ADC (mediana da janela -> IIR) e pelo detector, como em
+// wait_for_stable_readings. Para cada tau o programa mostra quando o detector declara o sensor
+// estável e o erro nesse instante.
+//
+// O detector dispara quando a inclinação cai para cerca de TOLERANCIA / (SENSOR_SETTLE_JANELA - 1)
+// contagens por segundo, e o que falta da exponencial nesse ponto é inclinação * tau (mais o atraso
+// do IIR, ~2^IIR_SHIFT s). Então o erro residual cresce com tau: aquecimentos lentos saem com um
+// erro maior. O programa falha se o erro passar desse limite (mais meia tolerância de ruído),
+// se o detector disparar antes de encher a janela ou se um sinal que não se acomoda for dado
+// como estável. Os parâmetros abaixo espelham main/main.c e main/sensor_adc.h.
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "sensor_filter.h"
+
+#define JANELA              256     // SENSOR_ADC_WINDOW_SAMPLES
+#define IIR_SHIFT           3       // SENSOR_ADC_IIR_SHIFT
+#define TOLERANCIA          12      // ESTABILIZACAO_TOLERANCIA
+#define MAX_S               180     // ESTABILIZACAO_MAX_MS / 1000
+#define SENSOR_MIN          1406    // SENSOR_MIN_MOLHADO
+#define SENSOR_MAX          3817    // SENSOR_MAX_SECO
+#define INICIAL             3000    // Leitura logo após ligar.
+#define FINAL               2400    // Leitura do solo depois do aquecimento.
+
+static uint32_t s_semente = 12345;
+
+static double ruido(double sigma) {
+    double soma = 0;
+    for (int i = 0; i < 4; i++) {
+        s_semente = s_semente * 1103515245u + 12345u;
+        soma += ((s_semente >> 8) & 0xFFFF) / 65535.0 - 0.5;
+    }
+    return soma * sigma * 1.732;
+}
+
+// Passa o sinal pela cadeia do ADC, um segundo por vez, até o detector declarar estabilidade.
+// Retorna o segundo em que isso aconteceu (ou MAX_S) e o erro em contagens nesse instante.
+static int simular(double tau, double oscilacao, double *erro) {
+    uint16_t janela[JANELA];
+    sensor_iir_t iir;
+    sensor_settle_t detector;
+    sensor_iir_init(&iir, IIR_SHIFT);
+    sensor_settle_init(&detector, TOLERANCIA);
+    uint16_t filtrado = 0;
+    int t;
+    for (t = 1; t <= MAX_S; t++) {
+        double alvo = FINAL + (INICIAL - FINAL) * exp(-t / tau) + oscilacao * sin(t * 2 * M_PI / 40);
+        for (size_t i = 0; i < JANELA; i++) {
+            double x = alvo + ruido(30);
+            if (i % 97 == 0) x += 600; // Picos esparsos, que a mediana descarta.
+            janela[i] = (uint16_t)(x < 0 ? 0 : x > 4095 ? 4095 : x);
+        }
+        filtrado = sensor_iir_update(&iir, sensor_filter_median(janela, JANELA));
+        if (sensor_settle_update(&detector, filtrado)) break;
+    }
+    *erro = fabs((double)filtrado - FINAL);
+    return t > MAX_S ? MAX_S : t;
+}
+
+static double limite_erro(double tau) {
+    return (double)TOLERANCIA / (SENSOR_SETTLE_JANELA - 1) * (tau + (1 << IIR_SHIFT)) + TOLERANCIA / 2.0;
+}
+
+static double percentual(double contagens) {
+    return contagens * 100.0 / (SENSOR_MAX - SENSOR_MIN);
+}
+
+int main(void) {
+    static const double TAUS[] = {0.1, 5, 10, 20, 30, 40};
+    int falhas = 0;
+    printf("tau (s)  estável em (s)  erro (contagens / %%)  limite\n");
+    for (size_t i = 0; i < sizeof(TAUS) / sizeof(TAUS[0]); i++) {
+        double erro;
+        int t = simular(TAUS[i], 0, &erro);
+        bool ok = t < MAX_S && erro <= limite_erro(TAUS[i]);
+        printf("%7.1f  %14d  %9.0f / %.2f%%  %9.0f%s\n", TAUS[i], t, erro, percentual(erro), limite_erro(TAUS[i]),
+               ok ? "" : "  <- FALHA");
+        falhas += !ok;
+    }
+
+    // Um sensor sem aquecimento precisa ao menos encher a janela do detector.
+    double erro;
+    int t = simular(0.1, 0, &erro);
+    if (t < SENSOR_SETTLE_JANELA) {
+        printf("FALHA: estável em %d s, antes de encher a janela de %d leituras.\n", t, SENSOR_SETTLE_JANELA);
+        falhas++;
+    }
+    // Uma leitura que oscila mais que a tolerância nunca é dada como estável: vale o limite de 180 s.
+    t = simular(20, 3 * TOLERANCIA, &erro);
+    printf("Sinal oscilando ±%d contagens: %s\n", 3 * TOLERANCIA, t >= MAX_S ? "limite de 180 s" : "estável (FALHA)");
+    falhas += t < MAX_S;
+
+    if (falhas) {
+        printf("%d verificações falharam.\n", falhas);
+        return 1;
+    }
+    printf("Detector de estabilização OK.\n");
+    return 0;
+}
@@ -0,0 +1,198 @@
+// Benchmark e conferência dos núcleos de filtragem de main/sensor_filter.c no computador:
+// custo por amostra da média, da mediana (seleção de Wirth, comparada com qsort) e do IIR, e a
+// saída da cadeia da tarefa do ADC (mediana da janela -> IIR) sobre um traço de amostras brutas.
+//
+// Compilar e usar (no computador):
+//   gcc -O2 -I main tools/filtro_bench.c main/sensor_filter.c -lm -o filtro_bench
+//   ./filtro_bench                     # conferência, benchmark e traço sintético com ruído e picos
+//   ./filtro_bench amostras.csv        # traço gravado: uma amostra bruta por linha (última coluna)
+//
+// Com um traço gravado, a saída é um CSV por janela (janela,media,mediana,filtrado) para comparar
+// com o que o dispositivo publicou. Os parâmetros abaixo espelham main/sensor_adc.h e main/main.c.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "sensor_filter.h"
+
+#define JANELA          256     // SENSOR_ADC_WINDOW_SAMPLES
+#define IIR_SHIFT       3       // SENSOR_ADC_IIR_SHIFT
+#define SENSOR_MIN      1406    // SENSOR_MIN_MOLHADO
+#define SENSOR_MAX      3817    // SENSOR_MAX_SECO
+#define LIMITE_PCT      35      // Threshold do perfil padrão.
+#define REPETICOES      20000
+
+static uint32_t s_semente = 12345;
+
+static uint32_t aleatorio(void) {
+    s_semente = s_semente * 1103515245u + 12345u;
+    return s_semente >> 8;
+}
+
+// Ruído aproximadamente gaussiano (soma de 4 uniformes), em contagens.
+static double ruido(double sigma) {
+    double soma = 0;
+    for (int i = 0; i < 4; i++) soma += (aleatorio() & 0xFFFF) / 65535.0 - 0.5;
+    return soma * sigma * 1.732;
+}
+
+static double agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static int comparar(const void *a, const void *b) {
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+static int percentual(uint16_t raw) {
+    if (raw < SENSOR_MIN) raw = SENSOR_MIN;
+    if (raw > SENSOR_MAX) raw = SENSOR_MAX;
+    return 100 - ((raw - SENSOR_MIN) * 100) / (SENSOR_MAX - SENSOR_MIN);
+}
+
+static int conferir(void) {
+    uint16_t a[JANELA], b[JANELA];
+    for (int t = 0; t < REPETICOES; t++) {
+        size_t n = 1 + aleatorio() % JANELA;
+        uint32_t faixa = t % 2 ? 5 : 4096; // Metade das janelas com muitos valores repetidos.
+        uint32_t soma = 0;
+        for (size_t i = 0; i < n; i++) {
+            a[i] = b[i] = (uint16_t)(aleatorio() % faixa);
+            soma += a[i];
+        }
+        if (sensor_filter_mean(a, n) != (uint16_t)((soma + n / 2) / n)) {
+            printf("FALHA: média com n=%zu\n", n);
+            return 1;
+        }
+        qsort(b, n, sizeof(uint16_t), comparar);
+        if (sensor_filter_median(a, n) != b[n / 2]) {
+            printf("FALHA: mediana com n=%zu\n", n);
+            return 1;
+        }
+    }
+    // Degrau no IIR: converge para o novo valor sem erro residual.
+    sensor_iir_t f;
+    sensor_iir_init(&f, IIR_SHIFT);
+    for (int i = 0; i < 100; i++) sensor_iir_update(&f, 2000);
+    for (int i = 0; i < 100; i++) sensor_iir_update(&f, 1000);
+    if (sensor_iir_value(&f) != 1000) {
+        printf("FALHA: IIR parou em %u\n", sensor_iir_value(&f));
+        return 1;
+    }
+    printf("Conferência: %d janelas de média e mediana e o degrau do IIR OK.\n", REPETICOES);
+    return 0;
+}
+
+static void benchmark(void) {
+    static uint16_t base[JANELA], janela[JANELA];
+    for (size_t i = 0; i < JANELA; i++) base[i] = (uint16_t)(2400 + ruido(40));
+    volatile uint32_t sumidouro = 0;
+
+    double t0 = agora_ns();
+    for (int r = 0; r < REPETICOES; r++) sumidouro += sensor_filter_mean(base, JANELA);
+    double t1 = agora_ns();
+    for (int r = 0; r < REPETICOES; r++) {
+        memcpy(janela, base, sizeof(janela));
+        sumidouro += sensor_filter_median(janela, JANELA);
+    }
+    double t2 = agora_ns();
+    for (int r = 0; r < REPETICOES; r++) {
+        memcpy(janela, base, sizeof(janela));
+        qsort(janela, JANELA, sizeof(uint16_t), comparar);
+        sumidouro += janela[JANELA / 2];
+    }
+    double t3 = agora_ns();
+    sensor_iir_t f;
+    sensor_iir_init(&f, IIR_SHIFT);
+    for (int r = 0; r < REPETICOES; r++) {
+        for (size_t i = 0; i < JANELA; i++) sumidouro += sensor_iir_update(&f, base[i]);
+    }
+    double t4 = agora_ns();
+
+    double amostras = (double)REPETICOES * JANELA;
+    printf("Custo por amostra (janela de %d): média %.2f ns, mediana %.2f ns (qsort %.2f ns), IIR %.2f ns\n",
+           JANELA, (t1 - t0) / amostras, (t2 - t1) / amostras, (t3 - t2) / amostras, (t4 - t3) / amostras);
+}
+
+// Nível perto do limite com ruído de 40 contagens e picos de ±800 em 1% das amostras, como um
+// sensor com fiação longa. Conta quantas vezes o estado seco/úmido troca em cada saída.
+static void traco_sintetico(void) {
+    const int janelas = 600;
+    const uint16_t verdadeiro = (uint16_t)(SENSOR_MAX - (SENSOR_MAX - SENSOR_MIN) * LIMITE_PCT / 100);
+    uint16_t janela[JANELA];
+    sensor_iir_t f;
+    sensor_iir_init(&f, IIR_SHIFT);
+    double erro_unica = 0, erro_media = 0, erro_mediana = 0, erro_iir = 0;
+    int trocas[4] = {0};
+    bool seco[4] = {false};
+
+    for (int w = 0; w < janelas; w++) {
+        for (size_t i = 0; i < JANELA; i++) {
+            double x = verdadeiro + ruido(40);
+            uint32_t p = aleatorio() % 100;
+            if (p == 0) x += 800;
+            if (p == 1) x -= 800;
+            janela[i] = (uint16_t)(x < 0 ? 0 : x > 4095 ? 4095 : x);
+        }
+        uint16_t saida[4];
+        saida[0] = janela[0]; // Uma leitura única, como o antigo adc1_get_raw.
+        saida[1] = sensor_filter_mean(janela, JANELA);
+        saida[2] = sensor_filter_median(janela, JANELA);
+        saida[3] = sensor_iir_update(&f, saida[2]);
+        double *erros[4] = {&erro_unica, &erro_media, &erro_mediana, &erro_iir};
+        for (int k = 0; k < 4; k++) {
+            double e = (double)saida[k] - verdadeiro;
+            *erros[k] += e * e;
+            bool agora_seco = percentual(saida[k]) < LIMITE_PCT;
+            if (w > 0 && agora_seco != seco[k]) trocas[k]++;
+            seco[k] = agora_seco;
+        }
+    }
+    printf("Traço sintético (%d janelas no limite de %d%%): erro RMS em contagens / trocas seco-úmido\n",
+           janelas, LIMITE_PCT);
+    printf("  leitura única %.1f / %d\n  média %.1f / %d\n  mediana %.1f / %d\n  mediana+IIR %.1f / %d\n",
+           sqrt(erro_unica / janelas), trocas[0], sqrt(erro_media / janelas), trocas[1],
+           sqrt(erro_mediana / janelas), trocas[2], sqrt(erro_iir / janelas), trocas[3]);
+}
+
+// Reduz um traço gravado janela a janela, como a tarefa do ADC, e imprime o CSV resultante.
+static int traco_gravado(const char *caminho) {
+    FILE *f = fopen(caminho, "r");
+    if (f == NULL) {
+        perror(caminho);
+        return 1;
+    }
+    char linha[256];
+    uint16_t janela[JANELA];
+    size_t n = 0;
+    unsigned w = 0;
+    sensor_iir_t iir;
+    sensor_iir_init(&iir, IIR_SHIFT);
+    printf("janela,media,mediana,filtrado\n");
+    while (fgets(linha, sizeof(linha), f) != NULL) {
+        char *campo = strrchr(linha, ',');
+        campo = campo != NULL ? campo + 1 : linha;
+        char *fim;
+        long valor = strtol(campo, &fim, 10);
+        if (fim == campo || valor < 0 || valor > 4095) continue; // Cabeçalho ou linha inválida.
+        janela[n++] = (uint16_t)valor;
+        if (n < JANELA) continue;
+        uint16_t media = sensor_filter_mean(janela, n);
+        uint16_t mediana = sensor_filter_median(janela, n);
+        printf("%u,%u,%u,%u\n", w++, media, mediana, sensor_iir_update(&iir, mediana));
+        n = 0;
+    }
+    fclose(f);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) return traco_gravado(argv[1]);
+    if (conferir() != 0) return 1;
+    benchmark();
+    traco_sintetico();
+    return 0;
+}
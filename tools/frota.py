@@ -0,0 +1,494 @@
+#!/usr/bin/env python3
+# Gerador de carga: centenas de SoloScan virtuais publicando em um broker MQTT local, para medir
+# vazão de publicações, latência ponta a ponta e carga do broker antes de liberar uma versão do
+# firmware.
+#
+# Uso:
+#   pip install "paho-mqtt>=2"
+#   mosquitto -v                  # ou um serviço local; $SYS/broker/# traz a carga do broker
+#   python tools/frota.py --dispositivos 300 --intervalo 30 --duracao 600
+#   python tools/frota.py --dispositivos 500 --formato binario --lote 10 --sensores 4
+#   python tools/frota.py --dispositivos 300 --sempre-publica --comandos-por-min 0   # limite superior
+#
+# Cada dispositivo virtual é um cliente MQTT próprio com o tópico base soloscan/frota/<n>/planta.
+# Ele assina os tópicos de comando como o firmware e publica com QoS 1 nos mesmos formatos:
+# texto em leitura_raw/umidade_percentual (um vaso) ou /leituras (vários), ou quadros binários
+# em /telemetria (ver telemetria.py), além de /status e /alerta quando o vaso seca ou é regado.
+# Um assinante em soloscan/frota/# recebe tudo; como ele e os dispositivos usam o mesmo relógio,
+# a latência é medida de cada publish até a entrega.
+#
+# Por padrão o dispositivo se comporta como o firmware com AMOSTRAGEM_ADAPTATIVA: a mesma lógica de
+# main/adaptive_sampling.c escolhe o intervalo (5 s durante uma rega, até 300 s com o solo
+# estável) e só publica a leitura que saiu da banda morta de 2%, que mudou o estado seco/úmido ou
+# que completou o heartbeat de 1800 s. O quadro binário incompleto sai após TELEMETRIA_FLUSH_S.
+# A umidade seca devagar e cada vaso é regado de tempos em tempos; como no firmware, o início de
+# uma rega acorda o dispositivo no segundo seguinte. Com --sempre-publica cada dispositivo publica
+# todas as leituras a cada --intervalo, o que é um limite superior da carga, e não a carga real.
+#
+# Um cliente de controle publica comandos (/set_tipo, /config e /calibrar) em vasos sorteados, no
+# ritmo de --comandos-por-min para a frota toda. O dispositivo aplica limiar, histerese e intervalo
+# como o firmware; a resposta do firmware vai pelo Telegram, fora do broker, então não é simulada.
+import argparse
+import collections
+import heapq
+import math
+import random
+import sys
+import threading
+import time
+
+try:
+    import paho.mqtt.client as mqtt
+except ImportError:
+    sys.exit('instale o paho-mqtt: pip install "paho-mqtt>=2"')
+
+import telemetria
+
+BASE = 'soloscan/frota'
+COMANDOS = ('/set_tipo', '/config', '/calibrar')
+TIPOS = {'padrao': 35, 'cacto': 20, 'samambaia': 50}
+
+# Parâmetros de main/main.c, main/remote_config.h e main/telemetry.h.
+AMOSTRAGEM_MIN_S = 5
+AMOSTRAGEM_MAX_S = 300
+AMOSTRAGEM_DERIVADA_RAPIDA = 120     # %/h.
+AMOSTRAGEM_DERIVADA_ESTAVEL = 10     # %/h.
+AMOSTRAGEM_BANDA_MORTA = 2           # %.
+AMOSTRAGEM_HEARTBEAT_S = 1800
+TELEMETRIA_FLUSH_S = 300
+TELEMETRIA_MAX_LEITURAS = 32          # TELEMETRY_MAX_READINGS.
+INTERVALO_MIN_S, INTERVALO_MAX_S = 5, 86400
+BROKER_SYS = {
+    '$SYS/broker/clients/connected': 'clientes',
+    '$SYS/broker/load/messages/received/1min': 'msg_in/min',
+    '$SYS/broker/load/messages/sent/1min': 'msg_out/min',
+    '$SYS/broker/load/bytes/received/1min': 'bytes_in/min',
+    '$SYS/broker/heap/current': 'heap',
+}
+
+
+class Estatisticas:
+    def __init__(self) -> None:
+        self.lock = threading.Lock()
+        self.enviadas = 0
+        self.confirmadas = 0
+        self.recebidas = 0
+        self.perdidas = 0
+        self.latencias_ms: list[float] = []
+        self.comandos = 0
+        self.comandos_recebidos = 0
+        self.latencias_comando_ms: list[float] = []
+        self.leituras = 0
+        self.leituras_publicadas = 0
+        self.conectados = 0
+        self.pendentes: dict[str, collections.deque] = collections.defaultdict(collections.deque)
+        self.broker: dict[str, str] = {}
+
+    def enviada(self, topico: str) -> None:
+        with self.lock:
+            self.enviadas += 1
+            self.pendentes[topico].append(time.monotonic())
+
+    def recebida(self, topico: str) -> None:
+        agora = time.monotonic()
+        with self.lock:
+            fila = self.pendentes.get(topico)
+            if not fila:
+                return
+            # QoS 1 mantém a ordem por tópico e cada tópico tem um único publicador.
+            self.recebidas += 1
+            self.latencias_ms.append((agora - fila.popleft()) * 1000)
+
+    def comando_enviado(self, topico: str) -> None:
+        with self.lock:
+            self.comandos += 1
+            self.pendentes[topico].append(time.monotonic())
+
+    def comando_recebido(self, topico: str) -> None:
+        agora = time.monotonic()
+        with self.lock:
+            fila = self.pendentes.get(topico)
+            if not fila:
+                return
+            self.comandos_recebidos += 1
+            self.latencias_comando_ms.append((agora - fila.popleft()) * 1000)
+
+    def janela(self) -> tuple[int, int, int, list[float], list[float]]:
+        with self.lock:
+            valores = (self.enviadas, self.confirmadas, self.recebidas, self.latencias_ms, self.latencias_comando_ms)
+            self.enviadas = self.confirmadas = self.recebidas = 0
+            self.latencias_ms = []
+            self.latencias_comando_ms = []
+            return valores
+
+
+def percentil(valores: list[float], p: float) -> float:
+    if not valores:
+        return 0.0
+    ordenados = sorted(valores)
+    return ordenados[min(len(ordenados) - 1, int(len(ordenados) * p / 100))]
+
+
+class Amostragem:
+    """Mesma lógica de main/adaptive_sampling.c, com tempos em segundos."""
+
+    def __init__(self) -> None:
+        self.iniciado = False
+        self.publicou = False
+        self.derivada = 0
+        self.intervalo_s = 0.0
+        self.avaliado_s = 0
+        self.avaliado_percent = 0
+        self.publicado_s = 0
+        self.publicado_percent = 0
+
+    def atualizar(self, base_s: float, agora_s: int, percent: int) -> float:
+        base_s = max(base_s, AMOSTRAGEM_MIN_S)
+        maximo = max(AMOSTRAGEM_MAX_S, base_s)
+        if not self.iniciado:
+            self.iniciado = True
+            self.derivada = 0
+            self.intervalo_s = base_s
+        else:
+            dt = max(1, agora_s - self.avaliado_s)
+            derivada = int((percent - self.avaliado_percent) * 3600 / dt)  # Divisão inteira do C.
+            self.derivada += int((derivada - self.derivada) / 2)
+            if abs(self.derivada) >= AMOSTRAGEM_DERIVADA_RAPIDA:
+                self.intervalo_s = AMOSTRAGEM_MIN_S
+            elif abs(self.derivada) <= AMOSTRAGEM_DERIVADA_ESTAVEL:
+                self.intervalo_s = min(base_s if self.intervalo_s < base_s else self.intervalo_s * 2, maximo)
+            else:
+                self.intervalo_s = base_s
+        self.avaliado_s = agora_s
+        self.avaliado_percent = percent
+        return self.intervalo_s
+
+    def deve_publicar(self, agora_s: int, percent: int, mudou_estado: bool) -> bool:
+        publicar = (not self.publicou or mudou_estado or abs(percent - self.publicado_percent) >= AMOSTRAGEM_BANDA_MORTA
+                    or agora_s - self.publicado_s >= AMOSTRAGEM_HEARTBEAT_S)
+        if publicar:
+            self.publicou = True
+            self.publicado_s = agora_s
+            self.publicado_percent = percent
+        return publicar
+
+
+class Vaso:
+    """Solo que seca devagar e é regado de tempos em tempos depois de passar do limiar."""
+
+    def __init__(self, topico: str) -> None:
+        self.topico = topico
+        self.umidade = random.uniform(30, 80)
+        self.secagem = random.uniform(0.3, 1.5)     # %/h.
+        self.rega_inicio = math.inf
+        self.rega_alvo = 0.0
+        self.threshold = TIPOS['padrao']
+        self.histerese = 0
+        self.seco = False
+        self.amostragem = Amostragem()
+        self.atualizado = time.time()
+
+    def avancar(self, agora: float) -> float:
+        dt = agora - self.atualizado
+        self.atualizado = agora
+        if agora >= self.rega_inicio:
+            # A água sobe meio ponto percentual por segundo até o alvo; depois o solo volta a secar.
+            self.umidade = min(self.rega_alvo, self.umidade + dt * 0.5)
+            if self.umidade >= self.rega_alvo:
+                self.rega_inicio = math.inf
+        else:
+            self.umidade -= dt * self.secagem / 3600
+            if self.umidade < 30 and self.rega_inicio == math.inf:
+                self.rega_inicio = agora + random.uniform(600, 6 * 3600)
+                self.rega_alvo = random.uniform(70, 85)
+        return max(0.0, min(100.0, self.umidade + random.gauss(0, 0.3)))
+
+    def avaliar_estado(self, percent: int) -> bool:
+        """Mesma comparação de monitor_cycle; retorna True se o estado seco/úmido mudou."""
+        limite = self.threshold + self.histerese if self.seco else self.threshold
+        seco = percent < limite
+        mudou = seco != self.seco
+        self.seco = seco
+        return mudou
+
+
+class Dispositivo:
+    def __init__(self, indice: int, args: argparse.Namespace, stats: Estatisticas) -> None:
+        self.topico = f'{BASE}/{indice}/planta'
+        self.args = args
+        self.stats = stats
+        self.seq = 0
+        self.intervalo_s = args.intervalo
+        self.proximo_ciclo = 0.0
+        # Como na tabela de sensores do firmware: o primeiro vaso usa o tópico base e os outros /vasoN.
+        self.vasos = [Vaso(self.topico if i == 0 else f'{self.topico}/vaso{i + 1}') for i in range(args.sensores)]
+        self.lote: list[dict] = []
+        self.cliente = mqtt.Client(mqtt.CallbackAPIVersion.VERSION2, client_id=f'soloscan-frota-{indice}')
+        self.cliente.on_connect = self.ao_conectar
+        self.cliente.on_disconnect = self.ao_desconectar
+        self.cliente.on_publish = self.ao_confirmar
+        self.cliente.on_message = self.ao_receber
+
+    def conectar(self) -> None:
+        self.cliente.connect_async(self.args.broker, self.args.porta, keepalive=120)
+        self.cliente.loop_start()
+
+    def parar(self) -> None:
+        self.cliente.disconnect()
+        self.cliente.loop_stop()
+
+    def ao_conectar(self, cliente, userdata, flags, reason_code, properties) -> None:
+        # Mesmas assinaturas do firmware: os tópicos de comando de cada vaso.
+        cliente.subscribe([(vaso.topico + comando, 0) for vaso in self.vasos for comando in COMANDOS])
+        with self.stats.lock:
+            self.stats.conectados += 1
+
+    def ao_desconectar(self, cliente, userdata, flags, reason_code, properties) -> None:
+        with self.stats.lock:
+            self.stats.conectados -= 1
+
+    def ao_confirmar(self, cliente, userdata, mid, reason_code, properties) -> None:
+        with self.stats.lock:
+            self.stats.confirmadas += 1
+
+    def ao_receber(self, cliente, userdata, msg) -> None:
+        # Aplica o comando como remote_config.c; valores inválidos são ignorados (o firmware só avisa
+        # no Telegram). O estado é lido pela thread da agenda sem trava: são atribuições simples.
+        self.stats.comando_recebido(msg.topic)
+        texto = msg.payload.decode(errors='replace').strip()
+        for vaso in self.vasos:
+            if msg.topic == vaso.topico + '/set_tipo' and texto in TIPOS:
+                vaso.threshold = TIPOS[texto]
+            elif msg.topic == vaso.topico + '/config':
+                for par in texto.split(';'):
+                    chave, _, valor = par.partition('=')
+                    if not valor.isdigit():
+                        continue
+                    if chave == 'threshold' and int(valor) <= 100:
+                        vaso.threshold = int(valor)
+                    elif chave == 'histerese' and int(valor) <= 50:
+                        vaso.histerese = int(valor)
+                    elif chave == 'intervalo' and INTERVALO_MIN_S <= int(valor) <= INTERVALO_MAX_S:
+                        self.intervalo_s = int(valor)   # Vale para o dispositivo inteiro.
+            # /calibrar muda só a conversão de raw para %, que o modelo já gera direto em %.
+
+    def publicar(self, topico: str, payload: bytes) -> None:
+        self.stats.enviada(topico)
+        info = self.cliente.publish(topico, payload, qos=1)
+        if info.rc != mqtt.MQTT_ERR_SUCCESS:
+            with self.stats.lock:
+                self.stats.perdidas += 1
+                self.stats.enviadas -= 1
+                self.stats.pendentes[topico].pop()
+
+    def enviar_lote(self) -> None:
+        if self.lote:
+            self.publicar(self.topico + '/telemetria', telemetria.encode(self.lote))
+            self.lote = []
+
+    def acordar(self, agora: float) -> float:
+        """Um despertar de wait_next_cycle; faz o ciclo quando vence. Retorna o próximo despertar."""
+        if self.args.sempre_publica:
+            self.ciclo(agora)
+            return agora + self.intervalo_s * random.uniform(0.98, 1.02)
+        # O firmware confere a cada segundo se um vaso saiu da banda morta; aqui só a rega faz isso.
+        if agora >= self.proximo_ciclo or any(agora >= vaso.rega_inicio for vaso in self.vasos):
+            self.proximo_ciclo = agora + self.ciclo(agora)
+        elif self.lote and int(agora) - self.lote[0]['timestamp'] >= TELEMETRIA_FLUSH_S:
+            self.enviar_lote()
+        proximo = min([self.proximo_ciclo] + [vaso.rega_inicio + 1 for vaso in self.vasos])
+        if self.lote:
+            proximo = min(proximo, self.lote[0]['timestamp'] + TELEMETRIA_FLUSH_S)
+        return max(proximo, agora + 1)
+
+    def ciclo(self, agora: float) -> float:
+        """scan_cycle do firmware: avalia os vasos, publica o relatório e retorna o intervalo."""
+        agora_s = int(agora)
+        leituras = []
+        mudou_estado = False
+        intervalo = math.inf
+        for sensor, vaso in enumerate(self.vasos):
+            percent = round(vaso.avancar(agora))
+            mudou = vaso.avaliar_estado(percent)
+            if mudou:
+                self.publicar(vaso.topico + '/status', b'SECO' if vaso.seco else b'UMIDO')
+                self.publicar(vaso.topico + '/alerta', b'REGAR' if vaso.seco else b'OK')
+            mudou_estado |= mudou
+            with self.stats.lock:
+                self.stats.leituras += 1
+            if not self.args.sempre_publica:
+                intervalo = min(intervalo, vaso.amostragem.atualizar(self.intervalo_s, agora_s, percent))
+                if not vaso.amostragem.deve_publicar(agora_s, percent, mudou):
+                    continue
+            leituras.append({'timestamp': agora_s, 'sensor': sensor, 'raw': 3817 - percent * 24,
+                             'percent': percent, 'seco': vaso.seco})
+        if intervalo == math.inf:
+            intervalo = self.intervalo_s
+        if not leituras:
+            return intervalo
+        # Só as leituras publicadas recebem número de sequência, como em publish_report.
+        for leitura in leituras:
+            leitura['seq'] = self.seq
+            self.seq += 1
+        with self.stats.lock:
+            self.stats.leituras_publicadas += len(leituras)
+
+        if self.args.formato == 'binario':
+            if len(self.lote) + len(leituras) > TELEMETRIA_MAX_LEITURAS:
+                self.enviar_lote()
+            self.lote.extend(leituras)
+            if (mudou_estado or len(self.lote) >= self.args.lote or
+                    agora_s - self.lote[0]['timestamp'] >= TELEMETRIA_FLUSH_S):
+                self.enviar_lote()
+        elif len(self.vasos) == 1:
+            # Como em publish_report, os tópicos originais só valem para o dispositivo de um vaso;
+            # com vários, até uma leitura só vai para /leituras.
+            self.publicar(self.topico + '/leitura_raw', str(leituras[0]['raw']).encode())
+            self.publicar(self.topico + '/umidade_percentual', f"{leituras[0]['percent']}%".encode())
+        else:
+            texto = ';'.join(f"vaso{l['sensor'] + 1}={l['raw']},{l['percent']}%" for l in leituras)
+            self.publicar(self.topico + '/leituras', texto.encode())
+        return intervalo
+
+
+def controle(args: argparse.Namespace, stats: Estatisticas) -> mqtt.Client:
+    cliente = mqtt.Client(mqtt.CallbackAPIVersion.VERSION2, client_id='soloscan-frota-controle')
+    cliente.max_inflight_messages_set(1000)
+    cliente.connect(args.broker, args.porta, keepalive=120)
+    cliente.loop_start()
+    return cliente
+
+
+def comando_aleatorio(args: argparse.Namespace) -> tuple[str, bytes]:
+    """Um comando como os do README, para um vaso sorteado."""
+    dispositivo = random.randrange(args.dispositivos)
+    sensor = random.randrange(args.sensores)
+    topico = f'{BASE}/{dispositivo}/planta' + ('' if sensor == 0 else f'/vaso{sensor + 1}')
+    sorteio = random.random()
+    if sorteio < 0.4:
+        return topico + '/set_tipo', random.choice(list(TIPOS)).encode()
+    if sorteio < 0.8:
+        return topico + '/config', f'threshold={random.randint(20, 50)};histerese={random.randint(0, 5)}'.encode()
+    if sorteio < 0.9:
+        return topico + '/config', f'intervalo={random.choice((15, 30, 60, 120))}'.encode()
+    return topico + '/calibrar', random.choice((b'40', b'2100=40', b'limpar'))
+
+
+def monitor(args: argparse.Namespace, stats: Estatisticas) -> mqtt.Client:
+    cliente = mqtt.Client(mqtt.CallbackAPIVersion.VERSION2, client_id='soloscan-frota-monitor')
+
+    def ao_conectar(cliente, userdata, flags, reason_code, properties) -> None:
+        cliente.subscribe([(BASE + '/#', 1), ('$SYS/broker/#', 0)])
+
+    def ao_receber(cliente, userdata, msg) -> None:
+        if msg.topic.startswith('$SYS/'):
+            if msg.topic in BROKER_SYS:
+                with stats.lock:
+                    stats.broker[BROKER_SYS[msg.topic]] = msg.payload.decode(errors='replace')
+        elif not any(msg.topic.endswith(comando) for comando in COMANDOS):
+            stats.recebida(msg.topic)
+
+    cliente.on_connect = ao_conectar
+    cliente.on_message = ao_receber
+    cliente.max_inflight_messages_set(1000)
+    cliente.connect(args.broker, args.porta, keepalive=120)
+    cliente.loop_start()
+    return cliente
+
+
+def relatorio(stats: Estatisticas, segundos: float, decorrido: float, total: int) -> tuple[list[float], list[float]]:
+    enviadas, confirmadas, recebidas, latencias, latencias_comando = stats.janela()
+    with stats.lock:
+        conectados = stats.conectados
+        broker = ' '.join(f'{k}={v}' for k, v in stats.broker.items())
+    print(f't={decorrido:5.0f}s conectados={conectados}/{total} pub/s={enviadas / segundos:7.1f} '
+          f'puback/s={confirmadas / segundos:7.1f} entregues/s={recebidas / segundos:7.1f} '
+          f'latência ms p50={percentil(latencias, 50):.1f} p90={percentil(latencias, 90):.1f} '
+          f'p99={percentil(latencias, 99):.1f} max={max(latencias, default=0):.1f} '
+          f'comandos={len(latencias_comando)} p99={percentil(latencias_comando, 99):.1f} | {broker}', flush=True)
+    return latencias, latencias_comando
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Frota virtual de SoloScan contra um broker MQTT local')
+    parser.add_argument('--broker', default='localhost')
+    parser.add_argument('--porta', type=int, default=1883)
+    parser.add_argument('--dispositivos', type=int, default=100)
+    parser.add_argument('--sensores', type=int, default=1, choices=range(1, 9), metavar='1-8')
+    parser.add_argument('--intervalo', type=float, default=30,
+                        help='intervalo base em segundos (o /config intervalo=); a amostragem adaptativa varia em torno dele')
+    parser.add_argument('--sempre-publica', action='store_true',
+                        help='publica todas as leituras a cada intervalo, sem amostragem adaptativa (limite superior)')
+    parser.add_argument('--comandos-por-min', type=float, default=2, help='comandos por minuto para a frota toda')
+    parser.add_argument('--formato', choices=('texto', 'binario'), default='texto')
+    parser.add_argument('--lote', type=int, default=10, help='leituras por quadro no formato binário')
+    parser.add_argument('--duracao', type=float, default=300, help='segundos de medição')
+    parser.add_argument('--conexoes-por-s', type=float, default=50, help='ritmo de conexão dos dispositivos')
+    parser.add_argument('--relatorio', type=float, default=10, help='segundos entre linhas de relatório')
+    args = parser.parse_args()
+
+    stats = Estatisticas()
+    observador = monitor(args, stats)
+    controlador = controle(args, stats)
+    dispositivos = [Dispositivo(i, args, stats) for i in range(args.dispositivos)]
+    print(f'Conectando {len(dispositivos)} dispositivos a {args.broker}:{args.porta}...', flush=True)
+    for dispositivo in dispositivos:
+        dispositivo.conectar()
+        time.sleep(1 / args.conexoes_por_s)
+
+    # Os ciclos ficam espalhados pelo intervalo, como em uma frota real ligada em horários diferentes.
+    # A agenda usa o relógio de parede porque os vasos e os timestamps das leituras também usam.
+    inicio = time.time()
+    agenda = [(inicio + random.uniform(0, args.intervalo), i) for i in range(len(dispositivos))]
+    heapq.heapify(agenda)
+    proximo_relatorio = inicio + args.relatorio
+    proximo_comando = inicio + random.expovariate(args.comandos_por_min / 60) if args.comandos_por_min > 0 else math.inf
+    todas_latencias: list[float] = []
+    latencias_comando: list[float] = []
+    try:
+        while time.time() - inicio < args.duracao:
+            quando, indice = agenda[0]
+            agora = time.time()
+            if agora >= proximo_relatorio:
+                latencias, comandos = relatorio(stats, args.relatorio, agora - inicio, len(dispositivos))
+                todas_latencias += latencias
+                latencias_comando += comandos
+                proximo_relatorio += args.relatorio
+            if agora >= proximo_comando:
+                topico, payload = comando_aleatorio(args)
+                stats.comando_enviado(topico)
+                controlador.publish(topico, payload, qos=1)
+                proximo_comando += random.expovariate(args.comandos_por_min / 60)
+            if quando > agora:
+                time.sleep(max(0.0, min(quando, proximo_relatorio, proximo_comando) - agora))
+                continue
+            heapq.heapreplace(agenda, (dispositivos[indice].acordar(agora), indice))
+    except KeyboardInterrupt:
+        pass
+
+    time.sleep(2)  # Espera as últimas entregas.
+    _, _, _, latencias, comandos = stats.janela()
+    todas_latencias += latencias
+    latencias_comando += comandos
+    decorrido = time.time() - inicio
+    for dispositivo in dispositivos:
+        dispositivo.parar()
+    observador.loop_stop()
+    controlador.disconnect()
+    controlador.loop_stop()
+    with stats.lock:
+        sem_entrega = sum(len(fila) for fila in stats.pendentes.values())
+        perdidas = stats.perdidas
+        leituras, publicadas, enviados = stats.leituras, stats.leituras_publicadas, stats.comandos
+    por_hora = 3600 / decorrido / max(1, len(dispositivos))
+    print(f'\nResumo: {len(todas_latencias)} mensagens entregues, {sem_entrega} sem entrega, {perdidas} recusadas pelo cliente; '
+          f'latência ms p50={percentil(todas_latencias, 50):.1f} p99={percentil(todas_latencias, 99):.1f} '
+          f'max={max(todas_latencias, default=0):.1f}')
+    print(f'Por dispositivo e hora: {leituras * por_hora:.1f} leituras, {publicadas * por_hora:.1f} publicadas '
+          f'({"sempre publica, limite superior" if args.sempre_publica else "amostragem adaptativa"}); '
+          f'{len(latencias_comando)}/{enviados} comandos entregues, p99={percentil(latencias_comando, 99):.1f} ms')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
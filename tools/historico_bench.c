@@ -0,0 +1,150 @@
+// Benchmark de uma consulta ao histórico (main/history.c) no computador, com todos os níveis cheios:
+// enche o histórico de um vaso com leituras suficientes para dar a volta em todos os anéis e mede,
+// para cada nível e formato, uma resposta inteira de /historico como history_server.c a monta:
+// history_query em blocos de HISTORY_SERVER_BLOCO registros pelo cursor e history_format de cada bloco.
+//
+// Compilar e usar (no computador):
+//   gcc -O2 -I main tools/historico_bench.c main/history.c -o historico_bench
+//   ./historico_bench            # uma leitura a cada 30 s (INTERVALO_LEITURA_MS)
+//   ./historico_bench 5          # a cada 5 s, como durante uma rega com a amostragem adaptativa
+//
+// Mostra o período coberto por cada nível, o tempo médio de uma resposta (consulta e formatação
+// separadas), o p99 da consulta de um bloco (o único trecho em que history_server.c segura o mutex,
+// atrasando history_server_add) e os bytes gerados. Também confere a resposta: registros em ordem,
+// quantidade igual à capacidade do nível (mais o período parcial) e 8 bytes por registro no binário.
+// O envio pela rede não entra; no dispositivo, o tempo de cada requisição fica no histograma "http"
+// de /metrics.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "history.h"
+
+#define BLOCO           16      // HISTORY_SERVER_BLOCO
+#define DIAS            100     // Mais que HISTORY_DAY_SLOTS: todos os anéis dão a volta.
+#define INICIO          1700000000u
+#define REPETICOES      2000
+
+static const char *NIVEIS[HISTORY_TIERS] = { "bruto", "minuto", "hora", "dia" };
+static const size_t CAPACIDADES[HISTORY_TIERS] = {
+    HISTORY_RAW_SLOTS, HISTORY_MINUTE_SLOTS, HISTORY_HOUR_SLOTS, HISTORY_DAY_SLOTS,
+};
+
+static uint32_t s_semente = 12345;
+
+static uint32_t aleatorio(void) {
+    s_semente = s_semente * 1103515245u + 12345u;
+    return s_semente >> 8;
+}
+
+static double agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+// Umidade que seca devagar e volta a 80% numa rega a cada 3 dias, com um pouco de ruído.
+static uint32_t encher(history_t *h, uint32_t intervalo_s) {
+    uint32_t fim = INICIO + DIAS * 86400u, ts;
+    for (ts = INICIO; ts < fim; ts += intervalo_s) {
+        uint32_t desde_rega = (ts - INICIO) % (3 * 86400u);
+        int percent = 80 - (int)(desde_rega / 5400) + (int)(aleatorio() % 3) - 1;
+        if (percent < 0) percent = 0;
+        history_add(h, ts, (uint16_t)(3817 - percent * 24), (uint8_t)percent, percent < 35);
+    }
+    return (ts - INICIO) / intervalo_s;
+}
+
+static double s_blocos_ns[REPETICOES * (HISTORY_RAW_SLOTS / BLOCO + 1)];
+static size_t s_n_blocos;
+
+static int comparar(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    double consulta_ns;
+    double formatacao_ns;
+    size_t registros;
+    size_t bytes;
+    bool ok;
+} resposta_t;
+
+// Uma resposta inteira, com o mesmo laço de historico_get.
+static resposta_t responder(const history_t *h, history_tier_t nivel, bool binario) {
+    history_entry_t bloco[BLOCO];
+    static char pedaco[BLOCO * HISTORY_FORMAT_MAX];
+    resposta_t r = { .ok = true };
+    uint32_t cursor = 0, anterior = 0;
+    for (;;) {
+        double t0 = agora_ns();
+        size_t n = history_query(h, nivel, 0, UINT32_MAX, &cursor, bloco, BLOCO);
+        double t1 = agora_ns();
+        if (n == 0) break;
+        size_t len = history_format(bloco, n, nivel, binario, pedaco, sizeof(pedaco));
+        double t2 = agora_ns();
+        r.consulta_ns += t1 - t0;
+        r.formatacao_ns += t2 - t1;
+        if (s_n_blocos < sizeof(s_blocos_ns) / sizeof(s_blocos_ns[0])) s_blocos_ns[s_n_blocos++] = t1 - t0;
+        for (size_t i = 0; i < n; i++) {
+            if (bloco[i].timestamp < anterior) r.ok = false;
+            anterior = bloco[i].timestamp;
+        }
+        if (binario && len != n * 8) r.ok = false;
+        r.registros += n;
+        r.bytes += len;
+        if (n < BLOCO || bloco[n - 1].parcial) break;
+    }
+    size_t esperado = CAPACIDADES[nivel] + (nivel == HISTORY_RAW ? 0 : 1);
+    if (r.registros != esperado) r.ok = false;
+    return r;
+}
+
+int main(int argc, char **argv) {
+    uint32_t intervalo_s = argc > 1 ? (uint32_t)atoi(argv[1]) : 30;
+    if (intervalo_s == 0) {
+        fprintf(stderr, "Uso: %s [intervalo entre leituras em s]\n", argv[0]);
+        return 2;
+    }
+
+    static history_t h;
+    history_init(&h);
+    double t0 = agora_ns();
+    uint32_t leituras = encher(&h, intervalo_s);
+    double enchimento_ns = agora_ns() - t0;
+    printf("Histórico de %u bytes com %u leituras (uma a cada %u s, %d dias): %.0f ns por history_add.\n",
+           (unsigned)sizeof(history_t), (unsigned)leituras, (unsigned)intervalo_s, DIAS, enchimento_ns / leituras);
+
+    printf("\n%-7s %-4s %9s %8s %11s %11s %11s %11s %s\n", "nivel", "fmt", "cobre", "regs", "bytes", "total_us",
+           "consulta_us", "formato_us", "bloco_p99_us");
+    int falhas = 0;
+    for (history_tier_t nivel = HISTORY_RAW; nivel < HISTORY_TIERS; nivel++) {
+        history_entry_t primeiro, ultimo;
+        uint32_t cursor = 0;
+        history_query(&h, nivel, 0, UINT32_MAX, &cursor, &primeiro, 1);
+        ultimo = primeiro;
+        for (history_entry_t e; history_query(&h, nivel, 0, UINT32_MAX, &cursor, &e, 1) == 1 && !ultimo.parcial;) {
+            ultimo = e;
+        }
+        double horas = (ultimo.timestamp - primeiro.timestamp + history_tier_period(nivel) + intervalo_s * (nivel == HISTORY_RAW)) / 3600.0;
+
+        for (int binario = 0; binario < 2; binario++) {
+            resposta_t soma = {0}, r = {0};
+            s_n_blocos = 0;
+            for (int i = 0; i < REPETICOES; i++) {
+                r = responder(&h, nivel, binario);
+                soma.consulta_ns += r.consulta_ns;
+                soma.formatacao_ns += r.formatacao_ns;
+            }
+            qsort(s_blocos_ns, s_n_blocos, sizeof(double), comparar);
+            printf("%-7s %-4s %8.1fh %8u %11u %11.2f %11.2f %11.2f %11.2f%s\n", NIVEIS[nivel], binario ? "bin" : "csv",
+                   horas, (unsigned)r.registros, (unsigned)r.bytes,
+                   (soma.consulta_ns + soma.formatacao_ns) / REPETICOES / 1e3, soma.consulta_ns / REPETICOES / 1e3,
+                   soma.formatacao_ns / REPETICOES / 1e3, s_blocos_ns[s_n_blocos * 99 / 100] / 1e3, r.ok ? "" : "  FALHA");
+            falhas += !r.ok;
+        }
+    }
+    printf("\nConferência: %s\n", falhas ? "FALHA" : "OK");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,265 @@
+// Build do log de leituras (main/reading_log.c) no computador, sobre uma flash NOR simulada em RAM:
+// mede a vazão de gravação e de reenvio e testa a consistência depois de quedas de energia.
+//
+// Compilar e usar (no computador):
+//   gcc -O2 -I main tools/reading_log_host.c main/reading_log.c -o reading_log_host
+//   ./reading_log_host              # vazão + 2000 quedas de energia em pontos aleatórios
+//   ./reading_log_host 20000        # mais quedas
+//
+// A flash simulada se comporta como a NOR do ESP32: gravar só leva bits de 1 para 0 e apagar
+// devolve o setor inteiro para 0xFF. Na queda, a operação em andamento é cortada no meio (parte
+// dos bytes gravados ou parte do setor apagado) e nada mais é gravado até o log ser reaberto.
+// Depois de reabrir, as leituras pendentes precisam ser exatamente as que estavam pendentes antes
+// da queda, em ordem e íntegras. As únicas diferenças aceitas vêm da operação interrompida: a
+// leitura nova pode ou não aparecer, um lote reenviado pode ou não ter sido marcado e a rotação
+// para um setor cheio pode descartar as pendentes mais antigas, como já faria sem a queda.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "reading_log.h"
+
+#define TAMANHO_PARTICAO  (64 * 1024)   // Partição "fila" de partitions.csv.
+#define N_SETORES         (TAMANHO_PARTICAO / READING_LOG_SECTOR_SIZE)
+#define LOTE              TELEMETRY_MAX_READINGS // STORE_FORWARD_LOTE
+#define MAX_MODELO        (N_SETORES * READING_LOG_SLOTS)
+
+static uint8_t s_flash[TAMANHO_PARTICAO];
+static uint32_t s_apagamentos[N_SETORES];
+static uint64_t s_bytes_gravados;
+static long s_ate_queda = -1;   // Operações de flash até a queda (-1: sem queda programada).
+static bool s_desligado;
+
+static uint32_t s_semente = 12345;
+
+static uint32_t aleatorio(void) {
+    s_semente = s_semente * 1103515245u + 12345u;
+    return s_semente >> 8;
+}
+
+// Retorna true se esta operação é a que sofre a queda.
+static bool cair_agora(void) {
+    if (s_ate_queda < 0) return false;
+    if (s_ate_queda-- > 0) return false;
+    s_desligado = true;
+    return true;
+}
+
+static bool flash_read(void *ctx, uint32_t offset, void *buf, size_t len) {
+    (void)ctx;
+    memcpy(buf, &s_flash[offset], len);
+    return true;
+}
+
+static bool flash_write(void *ctx, uint32_t offset, const void *buf, size_t len) {
+    (void)ctx;
+    if (s_desligado) return false;
+    size_t gravar = cair_agora() ? aleatorio() % len : len;
+    const uint8_t *p = buf;
+    for (size_t i = 0; i < gravar; i++) s_flash[offset + i] &= p[i];
+    s_bytes_gravados += gravar;
+    return !s_desligado;
+}
+
+static bool flash_erase(void *ctx, uint32_t offset) {
+    (void)ctx;
+    if (s_desligado) return false;
+    size_t apagar = cair_agora() ? aleatorio() % READING_LOG_SECTOR_SIZE : READING_LOG_SECTOR_SIZE;
+    memset(&s_flash[offset], 0xFF, apagar);
+    s_apagamentos[offset / READING_LOG_SECTOR_SIZE]++;
+    return !s_desligado;
+}
+
+static const reading_log_flash_t FLASH = {
+    .read = flash_read,
+    .write = flash_write,
+    .erase_sector = flash_erase,
+    .ctx = NULL,
+    .size = TAMANHO_PARTICAO,
+};
+
+static double agora_s(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// O conteúdo de cada leitura é derivado do seq, para detectar registros trocados ou corrompidos.
+static telemetry_reading_t leitura_de(uint32_t seq) {
+    telemetry_reading_t r = {
+        .timestamp = 1000 + seq * 30,
+        .seq = seq,
+        .raw = (uint16_t)((seq * 7) & 0xFFF),
+        .percent = (uint8_t)(seq % 101),
+        .sensor = (uint8_t)(seq % 8),
+        .seco = (seq % 3) == 0,
+        .boot = (uint8_t)(seq / 97),
+    };
+    return r;
+}
+
+static bool leitura_confere(const telemetry_reading_t *r) {
+    telemetry_reading_t e = leitura_de(r->seq);
+    return r->timestamp == e.timestamp && r->raw == e.raw && r->percent == e.percent &&
+           r->sensor == e.sensor && r->seco == e.seco && r->boot == e.boot;
+}
+
+static void formatar(void) {
+    memset(s_flash, 0xFF, sizeof(s_flash));
+    memset(s_apagamentos, 0, sizeof(s_apagamentos));
+    s_bytes_gravados = 0;
+    s_ate_queda = -1;
+    s_desligado = false;
+}
+
+static int vazao(void) {
+    const uint32_t total = 200000;
+    static telemetry_reading_t lote[LOTE];
+    reading_log_t log;
+    formatar();
+    if (!reading_log_open(&log, &FLASH)) return 1;
+
+    double t0 = agora_s();
+    for (uint32_t seq = 0; seq < total; seq++) {
+        telemetry_reading_t r = leitura_de(seq);
+        if (!reading_log_append(&log, &r)) return 1;
+    }
+    double t1 = agora_s();
+    uint32_t pendentes = reading_log_pending(&log), reenviadas = 0;
+    size_t n;
+    while ((n = reading_log_peek(&log, lote, LOTE)) > 0) {
+        reenviadas += (uint32_t)n;
+        if (!reading_log_consume(&log, n)) return 1;
+    }
+    double t2 = agora_s();
+
+    uint32_t min = UINT32_MAX, max = 0;
+    for (size_t s = 0; s < N_SETORES; s++) {
+        if (s_apagamentos[s] < min) min = s_apagamentos[s];
+        if (s_apagamentos[s] > max) max = s_apagamentos[s];
+    }
+    printf("Vazão: %u gravações em %.0f ms (%.0f leituras/s), %u reenviadas em lotes de %d em %.1f ms (%.0f leituras/s)\n",
+           total, (t1 - t0) * 1e3, total / (t1 - t0), reenviadas, LOTE, (t2 - t1) * 1e3, reenviadas / (t2 - t1));
+    printf("Flash: %.1f bytes gravados por leitura, apagamentos por setor entre %u e %u, %u pendentes antes do reenvio "
+           "(%u descartadas por falta de espaço)\n",
+           (double)s_bytes_gravados / total, min, max, pendentes, log.descartados);
+    return reenviadas == pendentes ? 0 : 1;
+}
+
+// Modelo das pendentes: fila circular de seqs, na ordem do log.
+static uint32_t s_modelo[MAX_MODELO];
+static size_t s_modelo_ini, s_modelo_n;
+
+static uint32_t modelo_em(size_t i) {
+    return s_modelo[(s_modelo_ini + i) % MAX_MODELO];
+}
+
+static void modelo_descartar(size_t n) {
+    s_modelo_ini = (s_modelo_ini + n) % MAX_MODELO;
+    s_modelo_n -= n;
+}
+
+static unsigned s_quedas_gravacao, s_quedas_rotacao, s_quedas_reenvio;
+
+static int queda(unsigned tentativa) {
+    static telemetry_reading_t saida[MAX_MODELO + 1];
+    reading_log_t log;
+    formatar();
+    s_modelo_ini = s_modelo_n = 0;
+    if (!reading_log_open(&log, &FLASH)) return 1;
+
+    // Até 3 voltas na partição, com o broker ora fora (só gravações), ora reenviando.
+    uint32_t seq = 0;
+    uint32_t operacoes = aleatorio() % (3 * MAX_MODELO);
+    bool reenviando = false;
+    for (uint32_t i = 0; i < operacoes; i++) {
+        if (aleatorio() % 500 == 0) reenviando = !reenviando;
+        if (reenviando && aleatorio() % 2) {
+            size_t n = reading_log_peek(&log, saida, LOTE);
+            if (!reading_log_consume(&log, n)) return 1;
+            modelo_descartar(n);
+        } else {
+            telemetry_reading_t r = leitura_de(seq++);
+            uint32_t descartados = log.descartados;
+            if (!reading_log_append(&log, &r)) return 1;
+            modelo_descartar(log.descartados - descartados);
+            s_modelo[(s_modelo_ini + s_modelo_n++) % MAX_MODELO] = r.seq;
+        }
+    }
+
+    // Em um quarto das tentativas a queda pega a rotação para o próximo setor (apagamento + cabeçalho).
+    if (aleatorio() % 4 == 0) {
+        while (log.escrita.slot < READING_LOG_SLOTS) {
+            telemetry_reading_t r = leitura_de(seq++);
+            if (!reading_log_append(&log, &r)) return 1;
+            s_modelo[(s_modelo_ini + s_modelo_n++) % MAX_MODELO] = r.seq;
+        }
+    }
+
+    // A próxima operação sofre a queda em uma das suas gravações ou apagamentos.
+    bool consumo = s_modelo_n > 0 && aleatorio() % 3 == 0;
+    bool rotacao = !consumo && log.escrita.slot >= READING_LOG_SLOTS;
+    size_t lote = 0;
+    s_ate_queda = rotacao ? aleatorio() % 3 : 0;
+    if (consumo) {
+        lote = reading_log_peek(&log, saida, LOTE);
+        reading_log_consume(&log, lote);
+    } else {
+        telemetry_reading_t r = leitura_de(seq);
+        reading_log_append(&log, &r);
+    }
+    bool caiu = s_desligado;
+    if (caiu) {
+        if (consumo) s_quedas_reenvio++;
+        else if (rotacao) s_quedas_rotacao++;
+        else s_quedas_gravacao++;
+    }
+    s_ate_queda = -1;
+    s_desligado = false;
+
+    reading_log_t reaberto;
+    if (!reading_log_open(&reaberto, &FLASH)) {
+        printf("FALHA na queda %u: o log não reabriu.\n", tentativa);
+        return 1;
+    }
+    size_t n = 0, parte;
+    while (n < MAX_MODELO + 1 && (parte = reading_log_peek(&reaberto, &saida[n], LOTE)) > 0) {
+        // Consome para chegar ao fim; a flash é refeita na próxima tentativa.
+        n += parte;
+        if (!reading_log_consume(&reaberto, parte)) return 1;
+    }
+
+    // As pendentes reabertas são um sufixo das do modelo, mais talvez a leitura nova.
+    bool nova = n > 0 && saida[n - 1].seq == seq && !consumo;
+    size_t antigas = n - (nova ? 1 : 0);
+    size_t perdidas = s_modelo_n - antigas;
+    size_t perda_aceita = consumo ? lote : READING_LOG_SLOTS;
+    if (antigas > s_modelo_n || perdidas > perda_aceita || (perdidas > 0 && consumo && perdidas != lote)) {
+        printf("FALHA na queda %u: %zu pendentes reabertas, %zu no modelo (%s, queda %s).\n", tentativa, n,
+               (size_t)s_modelo_n, consumo ? "reenvio" : "gravação", caiu ? "ocorreu" : "não ocorreu");
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint32_t esperado = i < antigas ? modelo_em(perdidas + i) : seq;
+        if (saida[i].seq != esperado || !leitura_confere(&saida[i])) {
+            printf("FALHA na queda %u: registro %zu com seq %u, esperado %u.\n", tentativa, i, saida[i].seq, esperado);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    unsigned quedas = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 2000;
+    if (vazao() != 0) {
+        printf("FALHA no teste de vazão.\n");
+        return 1;
+    }
+    for (unsigned i = 0; i < quedas; i++) {
+        if (queda(i) != 0) return 1;
+    }
+    printf("Consistência: %u quedas de energia (%u gravando uma leitura, %u trocando de setor, %u marcando um lote) "
+           "sem leituras corrompidas, fora de ordem ou perdidas.\n",
+           quedas, s_quedas_gravacao, s_quedas_rotacao, s_quedas_reenvio);
+    return 0;
+}
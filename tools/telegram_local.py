@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+# Servidor HTTPS local no lugar de api.telegram.org, para testar o notificador do Telegram
+# (main/telegram_notifier.c) sem internet: reaproveitamento da conexão TLS, agrupamento de alertas
+# e espera crescente depois de falhas.
+#
+# Uso:
+#   python tools/telegram_local.py --host 192.168.0.10                 # certificado novo, porta 8443
+#   python tools/telegram_local.py --host 192.168.0.10 --falhas 0.3 --atraso-ms 800
+#   python tools/telegram_local.py --auto-teste                        # confere o servidor sozinho
+#
+# No firmware (main/main.c): TELEGRAM_API_URL "https://192.168.0.10:8443", TELEGRAM_TOKEN e
+# TELEGRAM_CHAT_ID iguais a --token e --chat-id, e TELEGRAM_CERT_PEM com o certificado impresso na
+# partida (já como string C). O certificado é autoassinado, gerado pelo openssl, com o --host no
+# subjectAltName, que o ESP-TLS confere. Ele fica em --dir e é reaproveitado nas próximas vezes.
+#
+# Cada POST em /bot<token>/sendMessage é registrado com a conexão TCP em que chegou e o número de
+# alertas agrupados (o notificador separa as mensagens com uma linha em branco). --falhas responde
+# 500 a uma fração das requisições e --atraso-ms segura cada resposta, para ver o backoff e o
+# agrupamento do que chega durante a espera. Ao sair (Ctrl+C) o resumo mostra requisições por
+# conexão: com o keep-alive funcionando, várias requisições usam a mesma conexão.
+import argparse
+import http.client
+import http.server
+import ipaddress
+import json
+import os
+import random
+import ssl
+import subprocess
+import sys
+import threading
+import time
+import urllib.parse
+
+
+class Estatisticas:
+    def __init__(self) -> None:
+        self.lock = threading.Lock()
+        self.conexoes = 0
+        self.requisicoes = 0
+        self.entregues = 0
+        self.alertas = 0
+        self.falhas = 0
+
+
+def gerar_certificado(host: str, diretorio: str) -> tuple[str, str]:
+    certificado = os.path.join(diretorio, f'telegram_local_{host}.pem')
+    chave = os.path.join(diretorio, f'telegram_local_{host}.key')
+    if os.path.exists(certificado) and os.path.exists(chave):
+        return certificado, chave
+    try:
+        ipaddress.ip_address(host)
+        san = f'IP:{host}'
+    except ValueError:
+        san = f'DNS:{host}'
+    subprocess.run(['openssl', 'req', '-x509', '-newkey', 'rsa:2048', '-nodes', '-days', '3650',
+                    '-keyout', chave, '-out', certificado, '-subj', f'/CN={host}',
+                    '-addext', f'subjectAltName={san}'], check=True, capture_output=True)
+    return certificado, chave
+
+
+def como_string_c(certificado: str) -> str:
+    with open(certificado) as f:
+        linhas = f.read().strip().splitlines()
+    return '\n'.join(f'    "{linha}\\n"' + (' \\' if i < len(linhas) - 1 else '') for i, linha in enumerate(linhas))
+
+
+def criar_servidor(args: argparse.Namespace, stats: Estatisticas, certificado: str, chave: str) -> http.server.ThreadingHTTPServer:
+    class Telegram(http.server.BaseHTTPRequestHandler):
+        protocol_version = 'HTTP/1.1'  # Mantém a conexão aberta entre requisições, como a API real.
+
+        def setup(self) -> None:
+            super().setup()
+            with stats.lock:
+                stats.conexoes += 1
+                self.conexao = stats.conexoes
+
+        def responder(self, status: int, corpo: dict) -> None:
+            dados = json.dumps(corpo).encode()
+            self.send_response(status)
+            self.send_header('Content-Type', 'application/json')
+            self.send_header('Content-Length', str(len(dados)))
+            self.end_headers()
+            self.wfile.write(dados)
+
+        def do_POST(self) -> None:
+            tamanho = int(self.headers.get('Content-Length', 0))
+            campos = urllib.parse.parse_qs(self.rfile.read(tamanho).decode(errors='replace'))
+            with stats.lock:
+                stats.requisicoes += 1
+            if self.path != f'/bot{args.token}/sendMessage':
+                self.responder(404, {'ok': False, 'error_code': 404, 'description': 'Not Found'})
+                return
+            texto = campos.get('text', [''])[0]
+            if campos.get('chat_id', [''])[0] != args.chat_id or not texto:
+                self.responder(400, {'ok': False, 'error_code': 400, 'description': 'Bad Request: chat not found'})
+                return
+            time.sleep(args.atraso_ms / 1000)
+            if random.random() < args.falhas:
+                with stats.lock:
+                    stats.falhas += 1
+                print(f'[conexão {self.conexao}] falha simulada (500)', flush=True)
+                self.responder(500, {'ok': False, 'error_code': 500, 'description': 'Internal Server Error'})
+                return
+            alertas = texto.count('\n\n') + 1
+            with stats.lock:
+                stats.entregues += 1
+                stats.alertas += alertas
+            if not args.silencioso:
+                print(f'[conexão {self.conexao}] {alertas} alerta(s):\n  ' + texto.replace('\n', '\n  '), flush=True)
+            self.responder(200, {'ok': True, 'result': {'message_id': stats.entregues, 'text': texto}})
+
+        def log_message(self, formato: str, *valores) -> None:
+            pass
+
+    servidor = http.server.ThreadingHTTPServer(('0.0.0.0', args.porta), Telegram)
+    contexto = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    contexto.load_cert_chain(certificado, chave)
+    servidor.socket = contexto.wrap_socket(servidor.socket, server_side=True)
+    return servidor
+
+
+def resumo(stats: Estatisticas) -> str:
+    with stats.lock:
+        por_conexao = stats.requisicoes / stats.conexoes if stats.conexoes else 0
+        return (f'{stats.requisicoes} requisições em {stats.conexoes} conexões TLS ({por_conexao:.1f} por conexão), '
+                f'{stats.entregues} entregues com {stats.alertas} alertas, {stats.falhas} falhas simuladas')
+
+
+def auto_teste(args: argparse.Namespace, stats: Estatisticas, certificado: str) -> int:
+    # Um cliente com keep-alive, como o esp_http_client, validando o certificado gerado pelo host.
+    contexto = ssl.create_default_context(cafile=certificado)
+    conexao = http.client.HTTPSConnection(args.host, args.porta, context=contexto, timeout=5)
+    cabecalhos = {'Content-Type': 'application/x-www-form-urlencoded'}
+
+    def post(caminho: str, campos: dict) -> tuple[int, dict]:
+        conexao.request('POST', caminho, urllib.parse.urlencode(campos), cabecalhos)
+        resposta = conexao.getresponse()
+        return resposta.status, json.loads(resposta.read())
+
+    envio = f'/bot{args.token}/sendMessage'
+    casos = [
+        ('mensagem única', post(envio, {'chat_id': args.chat_id, 'text': 'Planta secou!'}), 200),
+        ('alertas agrupados', post(envio, {'chat_id': args.chat_id, 'text': 'vaso1 seco\n\nvaso2 seco'}), 200),
+        ('token errado', post('/botERRADO/sendMessage', {'chat_id': args.chat_id, 'text': 'x'}), 404),
+        ('chat errado', post(envio, {'chat_id': '0', 'text': 'x'}), 400),
+    ]
+    falhas = 0
+    for nome, (status, corpo), esperado in casos:
+        ok = status == esperado and corpo['ok'] == (esperado == 200)
+        print(f'{nome}: {status} {"OK" if ok else f"FALHA (esperado {esperado})"}')
+        falhas += not ok
+    conexao.close()
+    with stats.lock:
+        reaproveitou = stats.conexoes == 1 and stats.requisicoes == len(casos) and stats.alertas == 3
+    print(f'Conexão reaproveitada: {"OK" if reaproveitou else "FALHA"} ({resumo(stats)})')
+    falhas += not reaproveitou
+    return 1 if falhas else 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Servidor HTTPS local no lugar da API do Telegram')
+    parser.add_argument('--host', default='localhost', help='IP ou nome do computador, como o ESP32 o acessa')
+    parser.add_argument('--porta', type=int, default=8443)
+    parser.add_argument('--token', default='TESTE')
+    parser.add_argument('--chat-id', default='12345')
+    parser.add_argument('--falhas', type=float, default=0, help='fração das requisições respondidas com 500')
+    parser.add_argument('--atraso-ms', type=float, default=0, help='espera antes de cada resposta')
+    parser.add_argument('--dir', default='.', help='onde guardar o certificado e a chave')
+    parser.add_argument('--silencioso', action='store_true', help='não mostra o texto de cada mensagem')
+    parser.add_argument('--auto-teste', action='store_true', help='sobe o servidor, confere as respostas e sai')
+    args = parser.parse_args()
+    if args.auto_teste:
+        args.host, args.silencioso = 'localhost', True
+
+    certificado, chave = gerar_certificado(args.host, args.dir)
+    stats = Estatisticas()
+    servidor = criar_servidor(args, stats, certificado, chave)
+    if args.auto_teste:
+        threading.Thread(target=servidor.serve_forever, daemon=True).start()
+        try:
+            return auto_teste(args, stats, certificado)
+        finally:
+            servidor.shutdown()
+
+    print(f'Servindo em https://{args.host}:{args.porta} (token {args.token}, chat {args.chat_id}).')
+    print(f'Em main/main.c:\n#define TELEGRAM_API_URL    "https://{args.host}:{args.porta}"\n'
+          f'#define TELEGRAM_CERT_PEM   \\\n{como_string_c(certificado)}\n', flush=True)
+    try:
+        servidor.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    print(f'\nResumo: {resumo(stats)}')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# Decodificador dos quadros binários publicados em soloscan/planta/telemetria
+# e comparação do custo de envio com os tópicos de texto.
+#
+# Uso:
+#   python tools/telemetria.py decode <quadro em hex>
+#   python tools/telemetria.py custo [--lote 10] [--intervalo 30]
+#
+# O formato é o mesmo descrito em main/telemetry.h.
+import argparse
+import struct
+import sys
+
+VERSAO = 1
+CABECALHO = struct.Struct('<BBII')
+LEITURA = struct.Struct('<HBH')
+FLAG_SECO = 0x8000
+SENSOR_SHIFT = 12
+SENSOR_MASK = 0x7
+
+BASE_TOPIC = 'soloscan/planta'
+TCP_IP_OVERHEAD = 40  # Cabeçalhos IPv4 + TCP sem opções, por pacote.
+
+
+def decode(quadro: bytes) -> list[dict]:
+    versao, n, seq, ts = CABECALHO.unpack_from(quadro, 0)
+    if versao != VERSAO:
+        raise ValueError(f'versão de quadro desconhecida: {versao}')
+    if len(quadro) < CABECALHO.size + n * LEITURA.size:
+        raise ValueError('quadro truncado')
+    leituras = []
+    for i in range(n):
+        raw_flags, percent, delta = LEITURA.unpack_from(quadro, CABECALHO.size + i * LEITURA.size)
+        ts += delta
+        leituras.append({
+            'seq': seq + i,
+            'timestamp': ts,
+            'sensor': (raw_flags >> SENSOR_SHIFT) & SENSOR_MASK,
+            'raw': raw_flags & 0x0FFF,
+            'percent': percent,
+            'seco': bool(raw_flags & FLAG_SECO),
+        })
+    return leituras
+
+
+def encode(leituras: list[dict]) -> bytes:
+    # Mesmo formato de telemetry_encode(): deltas de horário limitados a 16 bits.
+    primeira = leituras[0]
+    quadro = bytearray(CABECALHO.pack(VERSAO, len(leituras), primeira['seq'], primeira['timestamp']))
+    anterior = primeira['timestamp']
+    for leitura in leituras:
+        raw_flags = ((leitura['raw'] & 0x0FFF) | ((leitura['sensor'] & SENSOR_MASK) << SENSOR_SHIFT) |
+                     (FLAG_SECO if leitura['seco'] else 0))
+        quadro += LEITURA.pack(raw_flags, leitura['percent'], min(leitura['timestamp'] - anterior, 0xFFFF))
+        anterior = leitura['timestamp']
+    return bytes(quadro)
+
+
+def bytes_publish_qos1(topico: str, payload_len: int) -> int:
+    # PUBLISH (cabeçalho fixo + tópico + packet id + payload) mais o PUBACK de volta.
+    restante = 2 + len(topico) + 2 + payload_len
+    publish = 1 + (1 if restante < 128 else 2) + restante
+    puback = 4
+    return publish + puback + 2 * TCP_IP_OVERHEAD
+
+
+def custo(lote: int, intervalo_s: int, sensores: int) -> None:
+    leituras_hora = 3600 // intervalo_s
+    if sensores == 1:
+        # Texto: "2841" em leitura_raw e "57%" em umidade_percentual a cada ciclo.
+        texto_pub = 2 * leituras_hora
+        texto_bytes = leituras_hora * (bytes_publish_qos1(BASE_TOPIC + '/leitura_raw', 4) +
+                                       bytes_publish_qos1(BASE_TOPIC + '/umidade_percentual', 3))
+    else:
+        # Texto: uma publicação em /leituras por ciclo, "vaso1=2841,57%;vaso2=...".
+        payload_texto = sum(len(f'vaso{i + 1}=2841,57%') for i in range(sensores)) + sensores - 1
+        texto_pub = leituras_hora
+        texto_bytes = leituras_hora * bytes_publish_qos1(BASE_TOPIC + '/leituras', payload_texto)
+    # Binário: as leituras de um ciclo nunca são divididas entre quadros.
+    ciclos_por_quadro = max(1, min(-(-lote // sensores), 32 // sensores))
+    quadros = -(-leituras_hora // ciclos_por_quadro)
+    payload = CABECALHO.size + ciclos_por_quadro * sensores * LEITURA.size
+    bin_bytes = quadros * bytes_publish_qos1(BASE_TOPIC + '/telemetria', payload)
+    print(f'Leituras por hora: {leituras_hora} por sensor, {sensores} sensor(es)')
+    print(f'Texto:   {texto_pub:5d} publicações/h  {texto_bytes:7d} bytes/h  ({texto_bytes // sensores} bytes/h por sensor)')
+    print(f'Binário: {quadros:5d} publicações/h  {bin_bytes:7d} bytes/h  ({bin_bytes // sensores} bytes/h por sensor, '
+          f'{payload} bytes por quadro)')
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Telemetria binária do SoloScan')
+    sub = parser.add_subparsers(dest='comando', required=True)
+    p_dec = sub.add_parser('decode', help='decodifica um quadro em hexadecimal')
+    p_dec.add_argument('quadro')
+    p_custo = sub.add_parser('custo', help='compara bytes e publicações por hora')
+    p_custo.add_argument('--lote', type=int, default=10)
+    p_custo.add_argument('--intervalo', type=int, default=30, help='segundos entre leituras')
+    p_custo.add_argument('--sensores', type=int, default=1, choices=range(1, 9), metavar='1-8')
+    args = parser.parse_args()
+
+    if args.comando == 'decode':
+        for leitura in decode(bytes.fromhex(args.quadro)):
+            print(leitura)
+    else:
+        custo(args.lote, args.intervalo, args.sensores)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())